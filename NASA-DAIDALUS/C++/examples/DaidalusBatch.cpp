@@ -118,9 +118,8 @@ int main(int argc, const char* argv[]) {
 		std::string arga = argv[a];
 		options += arga + " ";
 		if (walker.processOptions(argv,argc,a)) {
-			++a;
 			options += walker.getOptionsString();
-		} if (arga == "--help" || arga == "-help" || arga == "-h") {
+		} else if (arga == "--help" || arga == "-help" || arga == "-h") {
 			DaidalusBatch::printHelpMsg();
 		} else if (startsWith(arga,"--conf") || startsWith(arga,"-conf") || arga == "-c") {
 			config = argv[++a];
@@ -0,0 +1,529 @@
+/*
+ * Copyright (c) 2021 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+
+/**
+ * DaidalusCampaign runs a Monte Carlo campaign on a daa encounter file. Every replicate perturbs
+ * the states of the ownship (and optionally of the traffic aircraft) with Gaussian offsets, which
+ * are drawn once per replicate and aircraft, and then walks the encounter computing alerting and
+ * bands at every time step. Replicates are distributed among the threads of DaidalusThreadPool.
+ * Aggregated metrics are reported every --report replicates and at the end of the campaign:
+ * - distribution of the first time of an alert of level k or higher, for every level k,
+ * - distribution of the minimum predicted horizontal miss distance over the encounter,
+ * - rate of time steps with saturated bands, i.e., bands without a NONE region.
+ * The replicate seeds only depend on the campaign seed and the replicate number, so results
+ * don't depend on the number of threads.
+ */
+
+#include "Daidalus.h"
+#include "DaidalusFileWalker.h"
+#include "DaidalusThreadPool.h"
+#include "ParameterData.h"
+#include "Units.h"
+#include "Util.h"
+#include "format.h"
+#include "string_util.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <map>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <thread>
+
+using namespace larcfm;
+
+// Band dimensions checked for saturation
+const int HDIR = 0;
+const int HS = 1;
+const int VS = 2;
+const int ALT = 3;
+const int DIMENSIONS = 4;
+const char* DIMENSION_NAMES[DIMENSIONS] = {"hdir", "hs", "vs", "alt"};
+
+// Offsets of one aircraft in a replicate, in internal units
+class Offsets {
+public:
+  double north;
+  double east;
+  double alt;
+  double hdir;
+  double hs;
+  double vs;
+  Offsets() : north(0), east(0), alt(0), hdir(0), hs(0), vs(0) {}
+};
+
+// Metrics of one replicate
+class Replicate {
+public:
+  std::vector<double> alert_time; // alert_time[k-1] is the first time of an alert of level >= k, NaN if none
+  double min_hmd; // Minimum predicted horizontal miss distance [m]
+  int steps; // Number of time steps with ownship
+  int saturated[DIMENSIONS]; // Number of time steps with saturated bands, per dimension
+  Replicate() : min_hmd(PINFINITY), steps(0) {
+    std::fill(saturated,saturated+DIMENSIONS,0);
+  }
+};
+
+// Distribution of a sample of values
+class Sample {
+public:
+  std::vector<double> values;
+
+  double percentile(double p) const {
+    if (values.empty()) {
+      return NaN;
+    }
+    std::vector<double> sorted = values;
+    std::sort(sorted.begin(),sorted.end());
+    int i = static_cast<int>(p*(sorted.size()-1)+0.5);
+    return sorted[i];
+  }
+
+  double mean() const {
+    double sum = 0;
+    for (int i = 0; i < static_cast<int>(values.size()); ++i) {
+      sum += values[i];
+    }
+    return values.empty() ? NaN : sum/values.size();
+  }
+
+  double stdev() const {
+    if (values.size() < 2) {
+      return NaN;
+    }
+    double m = mean();
+    double sum = 0;
+    for (int i = 0; i < static_cast<int>(values.size()); ++i) {
+      sum += Util::sq(values[i]-m);
+    }
+    return std::sqrt(sum/(values.size()-1));
+  }
+
+  std::string toString(const std::string& u) const {
+    if (values.empty()) {
+      return "N/A";
+    }
+    return "mean = "+FmPrecision(Units::to(u,mean()))+
+        ", std = "+FmPrecision(Units::to(u,stdev()))+
+        ", min = "+FmPrecision(Units::to(u,percentile(0)))+
+        ", p5 = "+FmPrecision(Units::to(u,percentile(0.05)))+
+        ", p50 = "+FmPrecision(Units::to(u,percentile(0.5)))+
+        ", p95 = "+FmPrecision(Units::to(u,percentile(0.95)))+
+        ", max = "+FmPrecision(Units::to(u,percentile(1)))+" ["+u+"]";
+  }
+};
+
+class DaidalusCampaign {
+public:
+  Offsets stdev; // Standard deviations of offsets
+  bool perturb_traffic;
+  unsigned long seed;
+  int levels;
+
+  DaidalusCampaign() : perturb_traffic(false), seed(0), levels(0) {}
+
+  // Draw offsets of an aircraft
+  Offsets draw(std::mt19937& gen) const {
+    std::normal_distribution<double> normal(0.0,1.0);
+    Offsets off;
+    off.north = stdev.north*normal(gen);
+    off.east = stdev.east*normal(gen);
+    off.alt = stdev.alt*normal(gen);
+    off.hdir = stdev.hdir*normal(gen);
+    off.hs = stdev.hs*normal(gen);
+    off.vs = stdev.vs*normal(gen);
+    return off;
+  }
+
+  static Position perturbPosition(const Position& pos, const Offsets& off) {
+    Position p = off.north != 0 || off.east != 0 ? pos.linearEst(off.north,off.east) : pos;
+    return p.mkAlt(pos.alt()+off.alt);
+  }
+
+  static Velocity perturbVelocity(const Velocity& vel, const Offsets& off) {
+    return Velocity::mkTrkGsVs(vel.trk()+off.hdir,Util::max(0.0,vel.gs()+off.hs),vel.vs()+off.vs);
+  }
+
+  static bool saturated(Daidalus& daa, int dim) {
+    int length = 0;
+    switch (dim) {
+    case HDIR: length = daa.horizontalDirectionBandsLength(); break;
+    case HS: length = daa.horizontalSpeedBandsLength(); break;
+    case VS: length = daa.verticalSpeedBandsLength(); break;
+    case ALT: length = daa.altitudeBandsLength(); break;
+    }
+    if (length == 0) {
+      return false;
+    }
+    for (int i = 0; i < length; ++i) {
+      BandsRegion::Region region = BandsRegion::UNKNOWN;
+      switch (dim) {
+      case HDIR: region = daa.horizontalDirectionRegionAt(i); break;
+      case HS: region = daa.horizontalSpeedRegionAt(i); break;
+      case VS: region = daa.verticalSpeedRegionAt(i); break;
+      case ALT: region = daa.altitudeRegionAt(i); break;
+      }
+      if (region == BandsRegion::NONE) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Run replicate number rep. The walker is only used by the calling thread.
+  void run(DaidalusFileWalker& walker, const Daidalus& config, int rep, Replicate& r) const {
+    std::seed_seq seq = {static_cast<unsigned long>(seed),static_cast<unsigned long>(rep)};
+    std::mt19937 gen(seq);
+    std::map<std::string,Offsets> offsets;
+    r = Replicate();
+    r.alert_time.assign(levels,NaN);
+    Daidalus daa(config);
+    walker.goToBeginning();
+    while (!walker.atEnd()) {
+      walker.readState(daa);
+      if (!daa.hasOwnship()) {
+        continue;
+      }
+      // Offsets are drawn in order of appearance of aircraft
+      TrafficState own = daa.getOwnshipState();
+      std::map<std::string,Offsets>::iterator it = offsets.find(own.getId());
+      if (it == offsets.end()) {
+        it = offsets.insert(std::make_pair(own.getId(),draw(gen))).first;
+      }
+      daa.updateOwnshipState(own.getId(),perturbPosition(own.getPosition(),it->second),
+          perturbVelocity(own.getGroundVelocity(),it->second),daa.getCurrentTime());
+      if (perturb_traffic) {
+        for (int ac = 1; ac <= daa.lastTrafficIndex(); ++ac) {
+          TrafficState intruder = daa.getAircraftStateAt(ac);
+          it = offsets.find(intruder.getId());
+          if (it == offsets.end()) {
+            it = offsets.insert(std::make_pair(intruder.getId(),draw(gen))).first;
+          }
+          daa.updateTrafficState(ac,perturbPosition(intruder.getPosition(),it->second),
+              perturbVelocity(intruder.getGroundVelocity(),it->second));
+        }
+      }
+      ++r.steps;
+      for (int ac = 1; ac <= daa.lastTrafficIndex(); ++ac) {
+        int alert = daa.alertLevel(ac);
+        for (int level = 1; level <= alert && level <= levels; ++level) {
+          if (ISNAN(r.alert_time[level-1])) {
+            r.alert_time[level-1] = daa.getCurrentTime();
+          }
+        }
+        double hmd = daa.predictedHorizontalMissDistance(ac);
+        if (hmd < r.min_hmd) {
+          r.min_hmd = hmd;
+        }
+      }
+      for (int dim = 0; dim < DIMENSIONS; ++dim) {
+        if (saturated(daa,dim)) {
+          ++r.saturated[dim];
+        }
+      }
+    }
+  }
+
+};
+
+void printHelpMsg(int status = 0) {
+  std::cerr << "Usage:" << std::endl;
+  std::cerr << "  DaidalusCampaign [<option>] <daa_file>" << std::endl;
+  std::cerr << "  <option> can be" << std::endl;
+  std::cerr << "  --config <configuration-file> | no_sum | nom_a | nom_b | cd3d | tcasii\n\tLoad <configuration-file>" << std::endl;
+  std::cerr << "  --<var>=<val>\n\t<key> is any configuration variable and val is its value (including units, if any), e.g., --lookahead_time=5[min]" << std::endl;
+  std::cerr << "  --noise <field>=<std>\n\tStandard deviation of the Gaussian offset of <field>, which can be north, east, alt, hdir, hs, vs\n\t(including units, if any), e.g., --noise hdir=2[deg]" << std::endl;
+  std::cerr << "  --perturb_traffic\n\tPerturb states of traffic aircraft too. By default, only ownship states are perturbed" << std::endl;
+  std::cerr << "  --replicates <n>\n\tNumber of replicates (default: 1000)" << std::endl;
+  std::cerr << "  --seed <n>\n\tSeed of the campaign (default: 0)" << std::endl;
+  std::cerr << "  --threads <n>\n\tNumber of threads (default: number of cores)" << std::endl;
+  std::cerr << "  --report <n>\n\tReport aggregated metrics every <n> replicates (default: 100)" << std::endl;
+  std::cerr << "  --output <output_file>\n\tOutput metrics of every replicate to CSV file <output_file>" << std::endl;
+  std::cerr << "  --precision <n>\n\tOutput decimal precision" << std::endl;
+  std::cerr << "  --ownship <id>\n\tSpecify a particular aircraft as ownship" << std::endl;
+  std::cerr << "  --traffic <id1>,..,<idn>\nSpecify a list of aircraft as traffic" << std::endl;
+  std::cerr << "  --help\n\tPrint this message" << std::endl;
+  exit(status);
+}
+
+// Exit with usage message if option at index a of argv is not followed by a value
+void requireValue(int a, int argc, const std::string& option) {
+  if (a+1 >= argc) {
+    std::cerr << "** Error: Option " << option << " requires a value" << std::endl;
+    printHelpMsg(1);
+  }
+}
+
+void report(std::ostream& out, const std::vector<Replicate>& results, int levels, const std::string& uhor) {
+  int n = results.size();
+  out << "# Replicates: " << n << std::endl;
+  for (int level = 1; level <= levels; ++level) {
+    Sample times;
+    for (int i = 0; i < n; ++i) {
+      if (!ISNAN(results[i].alert_time[level-1])) {
+        times.values.push_back(results[i].alert_time[level-1]);
+      }
+    }
+    out << "Alert level >= " << level << ": " << times.values.size() << " replicates ("
+        << FmPrecision(n == 0 ? 0.0 : 100.0*times.values.size()/n) << "%), first time: "
+        << times.toString("s") << std::endl;
+  }
+  Sample hmd;
+  for (int i = 0; i < n; ++i) {
+    if (!ISINF(results[i].min_hmd) && !ISNAN(results[i].min_hmd)) {
+      hmd.values.push_back(results[i].min_hmd);
+    }
+  }
+  out << "Min HMD: " << hmd.toString(uhor) << std::endl;
+  long steps = 0;
+  for (int i = 0; i < n; ++i) {
+    steps += results[i].steps;
+  }
+  out << "Saturation rate:";
+  for (int dim = 0; dim < DIMENSIONS; ++dim) {
+    long saturated = 0;
+    for (int i = 0; i < n; ++i) {
+      saturated += results[i].saturated[dim];
+    }
+    out << (dim > 0 ? "," : "") << " " << DIMENSION_NAMES[dim] << " = "
+        << FmPrecision(steps == 0 ? 0.0 : 100.0*saturated/steps) << "%";
+  }
+  out << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+
+  // Declare an empty Daidalus object
+  Daidalus daa;
+  DaidalusCampaign campaign;
+
+  std::string input_file = "";
+  std::string output_file = "";
+  std::string ownship = "";
+  std::vector<std::string> traffic;
+
+  ParameterData params;
+  ParameterData noise;
+  int replicates = 1000;
+  int threads = std::thread::hardware_concurrency();
+  int report_every = 100;
+  int precision = 6;
+
+  for (int a=1;a < argc; ++a) {
+    std::string arga = argv[a];
+    bool assignment = arga.find('=') != std::string::npos;
+    if ((startsWith(arga,"--c") || startsWith(arga,"-c")) && !assignment) {
+      // Load configuration file
+      requireValue(a,argc,arga);
+      arga = argv[++a];
+      if (!daa.loadFromFile(arga)) {
+        if (arga == "no_sum") {
+          // Configure DAIDALUS as in DO-365B, without SUM
+          daa.set_DO_365B(true,false);
+        } else if (arga == "nom_a") {
+          // Configure DAIDALUS to Nominal A: Buffered DWC, Kinematic Bands, Turn Rate 1.5 [deg/s]
+          daa.set_Buffered_WC_DO_365(false);
+        } else if (arga == "nom_b") {
+          // Configure DAIDALUS to Nominal B: Buffered DWS, Kinematic Bands, Turn Rate 3.0 [deg/s]
+          daa.set_Buffered_WC_DO_365(true);
+        } else if (arga == "cd3d") {
+          // Configure DAIDALUS to CD3D parameters: Cylinder (5nmi,1000ft), Instantaneous Bands, Only Corrective Volume
+          daa.set_CD3D();
+        } else if (arga == "tcasii") {
+          // Configure DAIDALUS to ideal TCASII logic: TA is Preventive Volume and RA is Corrective One
+          daa.set_TCASII();
+        } else {
+          std::cerr << "** Error: File " << arga << " not found" << std::endl;
+          exit(1);
+        }
+      } else {
+        std::cout << "Loading configuration file " << arga << std::endl;
+      }
+    } else if (startsWith(arga,"--noise") || startsWith(arga,"-noise")) {
+      requireValue(a,argc,arga);
+      ++a;
+      noise.set(argv[a]);
+    } else if (startsWith(arga,"--perturb") || startsWith(arga,"-perturb")) {
+      campaign.perturb_traffic = true;
+    } else if (startsWith(arga,"--report") || startsWith(arga,"-report")) {
+      requireValue(a,argc,arga);
+      ++a;
+      std::istringstream(argv[a]) >> report_every;
+    } else if (startsWith(arga,"--rep") || startsWith(arga,"-rep")) {
+      requireValue(a,argc,arga);
+      ++a;
+      std::istringstream(argv[a]) >> replicates;
+    } else if (startsWith(arga,"--seed") || startsWith(arga,"-seed")) {
+      requireValue(a,argc,arga);
+      ++a;
+      std::istringstream(argv[a]) >> campaign.seed;
+    } else if (startsWith(arga,"--thr") || startsWith(arga,"-thr")) {
+      requireValue(a,argc,arga);
+      ++a;
+      std::istringstream(argv[a]) >> threads;
+    } else if (startsWith(arga,"--prec") || startsWith(arga,"-prec")) {
+      requireValue(a,argc,arga);
+      ++a;
+      std::istringstream(argv[a]) >> precision;
+    } else if ((startsWith(arga,"--o") || startsWith(arga,"-o")) && !assignment &&
+        !startsWith(arga,"--own") && !startsWith(arga,"-own")) {
+      requireValue(a,argc,arga);
+      output_file = argv[++a];
+    } else if (startsWith(arga,"-") && assignment) {
+      std::string keyval = arga.substr(arga.find_last_of('-')+1);
+      params.set(keyval);
+    } else if ((startsWith(arga,"--own") || startsWith(arga,"-own")) && !assignment) {
+      requireValue(a,argc,arga);
+      ++a;
+      ownship = argv[a];
+    } else if ((startsWith(arga,"--traf") || startsWith(arga,"-traf")) && !assignment) {
+      requireValue(a,argc,arga);
+      ++a;
+      std::vector<std::string> s = split(argv[a],",");
+      traffic.insert(traffic.end(),s.begin(),s.end());
+    } else if (startsWith(arga,"--h") || startsWith(arga,"-h")) {
+      printHelpMsg();
+    } else if (startsWith(arga,"-")){
+      std::cerr << "** Error: Unknown option " << arga << std::endl;
+      exit(1);
+    } else if (input_file == "") {
+      input_file = arga;
+    } else {
+      std::cerr << "** Error: Only one input file can be provided (" << a << ")" << std::endl;
+      exit(1);
+    }
+  }
+  if (daa.numberOfAlerters()==0) {
+    // If no alerter has been configured, configure alerters as in
+    // DO_365B Phase I, Phase II, and Non-Cooperative, with SUM
+    daa.set_DO_365B();
+  }
+  if (params.size() > 0) {
+    daa.setParameterData(params);
+  }
+  if (input_file == "") {
+    std::cerr << "** Error: One input file must be provided" << std::endl;
+    exit(1);
+  }
+  std::ifstream file(input_file.c_str());
+  if (!file.good()) {
+    std::cerr << "** Error: File " << input_file << " cannot be read" << std::endl;
+    exit(1);
+  }
+  file.close();
+  std::vector<std::string> fields = noise.getKeyList();
+  for (int i = 0; i < static_cast<int>(fields.size()); ++i) {
+    const std::string& field = fields[i];
+    if (field != "north" && field != "east" && field != "alt" &&
+        field != "hdir" && field != "hs" && field != "vs") {
+      std::cerr << "** Error: Unknown noise field " << field << std::endl;
+      exit(1);
+    }
+  }
+  campaign.stdev.north = noise.getValue("north");
+  campaign.stdev.east = noise.getValue("east");
+  campaign.stdev.alt = noise.getValue("alt");
+  campaign.stdev.hdir = noise.getValue("hdir");
+  campaign.stdev.hs = noise.getValue("hs");
+  campaign.stdev.vs = noise.getValue("vs");
+  campaign.levels = daa.maxNumberOfAlertLevels();
+  threads = Util::max(1,threads);
+  report_every = Util::max(1,report_every);
+
+  DaidalusParameters::setDefaultOutputPrecision(precision);
+  std::string uhor = daa.getUnitsOf("min_horizontal_recovery");
+  std::cout << "Processing DAIDALUS file " << input_file << std::endl;
+  std::cout << "Running " << replicates << " replicates in " << threads << " threads" << std::endl;
+
+  // One file walker per task, so that walkers are never shared by threads
+  std::vector<DaidalusFileWalker*> walkers;
+  for (int t = 0; t < threads; ++t) {
+    DaidalusFileWalker* walker = new DaidalusFileWalker(input_file);
+    if (ownship != "") {
+      walker->setOwnship(ownship);
+    }
+    if (!traffic.empty()) {
+      walker->selectTraffic(traffic);
+    }
+    walkers.push_back(walker);
+  }
+  DaidalusThreadPool::shared().setNumberOfThreads(threads-1);
+
+  std::ofstream out;
+  if (output_file != "") {
+    std::cout << "Generating CSV file " << output_file << std::endl;
+    out.open(output_file.c_str(), std::ios_base::out);
+    out << "Replicate";
+    for (int level = 1; level <= campaign.levels; ++level) {
+      out << ", Time of Alert Level >= " << level;
+    }
+    out << ", Min HMD, Time Steps";
+    for (int dim = 0; dim < DIMENSIONS; ++dim) {
+      out << ", Saturated " << DIMENSION_NAMES[dim];
+    }
+    out << std::endl;
+    for (int level = 1; level <= campaign.levels; ++level) {
+      out << ", [s]";
+    }
+    out << ", [" << uhor << "],";
+    for (int dim = 0; dim < DIMENSIONS; ++dim) {
+      out << ",";
+    }
+    out << std::endl;
+  }
+
+  // Replicates are run in chunks. Metrics are reported after every chunk.
+  std::vector<Replicate> results;
+  results.reserve(Util::max(0,replicates));
+  while (static_cast<int>(results.size()) < replicates) {
+    int first = results.size();
+    int count = Util::min(report_every,replicates-first);
+    results.resize(first+count);
+    std::vector<std::function<void()> > tasks;
+    for (int t = 0; t < Util::min(threads,count); ++t) {
+      tasks.push_back([&campaign,&walkers,&daa,&results,t,first,count,threads]() {
+        for (int i = t; i < count; i += threads) {
+          campaign.run(*walkers[t],daa,first+i,results[first+i]);
+        }
+      });
+    }
+    DaidalusThreadPool::shared().run(tasks);
+    if (output_file != "") {
+      for (int i = first; i < first+count; ++i) {
+        const Replicate& r = results[i];
+        out << i;
+        for (int level = 1; level <= campaign.levels; ++level) {
+          out << ", ";
+          if (!ISNAN(r.alert_time[level-1])) {
+            out << FmPrecision(r.alert_time[level-1]);
+          }
+        }
+        out << ", ";
+        if (!ISINF(r.min_hmd)) {
+          out << FmPrecision(Units::to(uhor,r.min_hmd));
+        }
+        out << ", " << r.steps;
+        for (int dim = 0; dim < DIMENSIONS; ++dim) {
+          out << ", " << r.saturated[dim];
+        }
+        out << std::endl;
+      }
+    }
+    report(std::cout,results,campaign.levels,uhor);
+  }
+  if (output_file != "") {
+    out.close();
+  }
+  for (int t = 0; t < threads; ++t) {
+    delete walkers[t];
+  }
+}
@@ -1,11 +1,13 @@
 #include "DaidalusProcessor.h"
 #include "Daidalus.h"
 #include "DaidalusFileWalker.h"
+#include "DaidalusFileStreamer.h"
 #include "Position.h"
 #include "SequenceReader.h"
 #include "Velocity.h"
 #include "Util.h"
 #include "string_util.h"
+#include <iostream>
 
 using namespace larcfm;
 
@@ -15,6 +17,7 @@ DaidalusProcessor::DaidalusProcessor() {
 	relative_ = 0;
 	options_ = "";
 	ownship_ = "";
+	stream_ = false;
 }
 
 double DaidalusProcessor::getFrom() const {
@@ -33,10 +36,13 @@ std::string DaidalusProcessor::getHelpString() {
 	s += "  --to t\n\tCheck up to time t\n";
 	s += "  --at [t | t+k | t-k]\n\tCheck times t, [t,t+k], or [t-k,t]. ";
 	s += "First time is denoted by +0. Last time is denoted by -0\n";
+	s += "  --stream\n\tRead one time step at a time, for long files sorted by time. ";
+	s += "Ignored when the last time is needed, i.e., --at [-k | -0]\n";
 	return s;
 }
 
-bool DaidalusProcessor::processOptions(const char* args[], int argc, int i) {
+// If args[i] is an option of the processor, process it, set i to its last argument, and return true
+bool DaidalusProcessor::processOptions(const char* args[], int argc, int& i) {
 	std::string argi = args[i];
 	if ((startsWith(argi,"--own") || startsWith(argi,"-own")) && i+1 < argc) {
 		++i;
@@ -59,6 +65,8 @@ bool DaidalusProcessor::processOptions(const char* args[], int argc, int i) {
 		argi = args[i];
 		to_ = Util::parse_double(argi);
 		options_ += argi+" ";
+	} else if (argi == "--stream" || argi == "-stream") {
+		stream_ = true;
 	} else if ((argi == "--at" || argi == "-at") && i+1 < argc) {
 		++i;
 		argi = args[i];
@@ -100,6 +108,10 @@ std::string DaidalusProcessor::getOptionsString() {
 }
 
 void DaidalusProcessor::processFile(const std::string& filename, Daidalus &daa) {
+	if (stream_ && (to_ >= 0 || relative_ >= 0)) {
+		streamFile(filename,daa);
+		return;
+	}
 	DaidalusFileWalker dw = DaidalusFileWalker(filename);
 
 	if (ownship_ != "") {
@@ -131,6 +143,39 @@ void DaidalusProcessor::processFile(const std::string& filename, Daidalus &daa)
 	}
 }
 
+// Same as processFile, but the file is read one time step at a time. Since the last time of the
+// file isn't known in advance, times are checked up to the end of the file when no upper bound is given.
+void DaidalusProcessor::streamFile(const std::string& filename, Daidalus &daa) {
+	DaidalusFileStreamer ds(filename);
 
+	if (ownship_ != "") {
+		ds.setOwnship(ownship_);
+	}
+	if (!traffic_.empty()) {
+		ds.selectTraffic(traffic_);
+	}
 
-
+	double from = from_;
+	double to = to_;
+	if (from < 0) {
+		from = ds.getTime();
+	}
+	if (to < 0) {
+		to = PINFINITY;
+	}
+	if (relative_ > 0) {
+		to = from + relative_;
+	}
+	if (relative_ < 0) {
+		from = to + relative_;
+	}
+	if (ds.goToTime(from) && from <= to) {
+		while (!ds.atEnd() && ds.getTime() <= to) {
+			ds.readState(daa);
+			processTime(daa,filename);
+		}
+	}
+	if (ds.hasError()) {
+		std::cerr << ds.getMessage();
+	}
+}
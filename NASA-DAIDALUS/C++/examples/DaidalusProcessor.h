@@ -19,6 +19,9 @@ private:
 	std::string options_;
 	std::string ownship_;
 	std::vector<std::string> traffic_;
+	bool stream_;
+
+	void streamFile(const std::string& filename, larcfm::Daidalus& daa);
 
 public:
 	DaidalusProcessor();
@@ -27,7 +30,7 @@ public:
 	virtual ~DaidalusProcessor() { }
 	static void getFileNames(std::vector<std::string>& txtFiles, const std::vector<std::string>& names, const std::string& ext, int i);
 	static std::string getHelpString();
-	bool processOptions(const char* args[], int argc, int i);
+	bool processOptions(const char* args[], int argc, int& i);
 	std::string getOptionsString();
 	void processFile(const std::string& filename, larcfm::Daidalus& daa);
 	virtual void processTime(larcfm::Daidalus& daa, const std::string& filename) = 0;
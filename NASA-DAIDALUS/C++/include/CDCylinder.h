@@ -179,6 +179,17 @@ public:
   // treatment of border cases in the generic bands algorithms
 
   virtual ConflictData conflictDetection(const Vect3& so, const Velocity& vo, const Vect3& si, const Velocity& vi, double B, double T) const;
+
+  /**
+   * Batched conflict detection for a list of ownship velocities, where the relative position is computed once.
+   */
+  virtual void conflictDetectionVelocities(std::vector<ConflictData>& dets, const Vect3& so, const std::vector<Velocity>& vos,
+      const Vect3& si, const Velocity& vi, double B, double T) const;
+
+  virtual bool horizontalCriticalTracks(std::vector<double>& trks, const Vect3& so, const Velocity& co, double r, const Vect3& si, const Velocity& vi,
+      double B, double T) const;
+
+  virtual double horizontalViolationRange(double vh) const;
   double timeOfClosestApproach(const Vect3& so, const Velocity& vo, const Vect3& si, const Velocity& vi, double B, double T) const;
 
   /** This returns a pointer to a new instance of this type of Detector3D.  You are responsible for destroying this instance when it is no longer needed. */
@@ -15,6 +15,7 @@
 #define CRITICALVECTORS2D_H_
 
 #include <list>
+#include <vector>
 #include "Consts.h"
 #include "Horizontal.h"
 
@@ -33,6 +34,14 @@ public:
   
   static std::list<Vect2> groundSpeeds(const Vect2& s, const Vect2& vo, const Vect2& vi,
                 const double D, const double T);
+
+  /*
+   * Add to trks the compass angles of the unit vectors u such that v = w + r*u satisfies
+   * a*v.sqv() + b*v + c = 0, i.e., the directions where the circle of center w and radius r
+   * crosses the circle (a != 0) or line (a == 0) defined by the equation.
+   */
+  static void circleTracks(std::vector<double>& trks, const Vect2& w, const double r,
+                const double a, const Vect2& b, const double c);
 };
 
 //  std::list<Vect2> tracks(const Vect2& s, const Vect2& vo, const Vect2& vi,
@@ -23,6 +23,8 @@
 #include "Alerter.h"
 #include "Detection3D.h"
 #include "IndexLevelT.h"
+#include "DaidalusThreadPool.h"
+#include "DaidalusResults.h"
 #include "string_util.h"
 #include "format.h"
 #include <vector>
@@ -100,6 +102,9 @@ private:
   DaidalusHsBands   hs_band_;
   DaidalusVsBands   vs_band_;
   DaidalusAltBands  alt_band_;
+  bool              parallel_bands_;
+
+  friend class DaidalusResults;
 
   void stale_bands();
 
@@ -231,6 +236,51 @@ public:
    */
   int addTrafficState(const std::string& id, const Position& pos, const Velocity& vel);
 
+  /**
+   * Update ownship state and current time, keeping current traffic aircraft. Traffic states are
+   * linearly projected into the new current time and kept until they are updated with
+   * updateTrafficState or removed with removeStaleTraffic. Traffic aircraft whose position is not
+   * of the same kind as the new ownship's, i.e., lat/lon or Euclidean, are removed. If ownship has
+   * not been set, id is different from current ownship's identifier, or time is in the past, this
+   * method behaves as setOwnshipState, i.e., all traffic is cleared.
+   * @param id Ownship's identifier
+   * @param pos Ownship's position
+   * @param vel Ownship's ground velocity
+   * @param time Time stamp of ownship's state
+   */
+  void updateOwnshipState(const std::string& id, const Position& pos, const Velocity& vel, double time);
+
+  /**
+   * Update position and velocity of traffic aircraft at index ac_idx, keeping its identifier,
+   * alerter, and SUM data. If time is different from current time, traffic state is projected,
+   * past or future, into current time.
+   * @param ac_idx Aircraft's index, between 1 and lastTrafficIndex()
+   * @param pos Aircraft's position
+   * @param vel Aircraft's ground velocity
+   * @param time Time stamp of aircraft's state
+   * @return true if aircraft was updated
+   */
+  bool updateTrafficState(int ac_idx, const Position& pos, const Velocity& vel, double time);
+
+  /**
+   * Update position and velocity of traffic aircraft at index ac_idx at current time,
+   * keeping its identifier, alerter, and SUM data.
+   * @param ac_idx Aircraft's index, between 1 and lastTrafficIndex()
+   * @param pos Aircraft's position
+   * @param vel Aircraft's ground velocity
+   * @return true if aircraft was updated
+   */
+  bool updateTrafficState(int ac_idx, const Position& pos, const Velocity& vel);
+
+  /**
+   * Remove traffic aircraft whose states have not been set or updated in the last max_age
+   * seconds, with respect to current time. Indices of remaining aircraft are compacted
+   * keeping their relative order.
+   * @param max_age Maximum age of traffic states [s]
+   * @return Number of removed aircraft
+   */
+  int removeStaleTraffic(double max_age);
+
   /**
    * Get index of aircraft with given name. Return -1 if no such index exists
    */
@@ -1786,6 +1836,14 @@ public:
    */
   bool loadFromFile(const std::string& file);
 
+  /**
+   *  Update current parameters with parameters from file, as loadFromFile. The file is parsed once
+   *  per process, unless it's modified. Alerters defined in the file, including their detector instances,
+   *  are shared with other Daidalus objects that load the same file and with copies of this object, until
+   *  they are modified. This is useful when many Daidalus objects are configured from the same file.
+   */
+  bool loadSharedFromFile(const std::string& file);
+
   /**
    *  Write parameters to file.
    */
@@ -1843,8 +1901,40 @@ public:
    */
   void reset();
 
+  /**
+   * Enable/disable parallel computation of bands. When enabled, refreshBands computes the four
+   * dimensions concurrently and, in every dimension, none bands of different aircraft are computed
+   * concurrently. Bands are computed by the thread pool shared by all Daidalus objects, whose number
+   * of threads is set via DaidalusThreadPool::shared().setNumberOfThreads(n). Parallel bands are
+   * disabled by default.
+   */
+  void setParallelBands(bool flag);
+
+  /**
+   * Return true if bands are computed in parallel.
+   */
+  bool isParallelBands() const;
+
   /* Main interface methods */
 
+  /* Methods here and below that take units as a string, e.g., "deg", are overloaded with typed
+   * units, e.g., units::deg. Typed units aren't parsed (see Unit), so they are preferable in code
+   * that is executed every cycle. */
+
+  /**
+   * Compute direction, horizontal speed, vertical speed, and altitude bands. Usually, bands are only
+   * computed when needed. This method is useful when bands in all dimensions are needed, since the
+   * four dimensions are computed concurrently when parallel bands are enabled.
+   */
+  void refreshBands();
+
+  /**
+   * Return an immutable snapshot of alerting and bands at current time. All results are computed
+   * once by this method. The snapshot doesn't share state with this object, so it can be queried
+   * concurrently by several threads, even while this object is updated with new states.
+   */
+  DaidalusResults snapshot();
+
   /**
    * Compute in acs list of aircraft identifiers contributing to conflict bands for given
    * conflict bands region.
@@ -1892,6 +1982,7 @@ public:
    * @param u units
    */
   Interval horizontalDirectionIntervalAt(int i, const std::string& u);
+  Interval horizontalDirectionIntervalAt(int i, Unit u);
 
   /**
    * @return the i-th region of the computed direction bands.
@@ -1911,6 +2002,7 @@ public:
    * @param u Units
    */
   int indexOfHorizontalDirection(double dir, const std::string& u);
+  int indexOfHorizontalDirection(double dir, Unit u);
 
   /**
    * @return the region of a given direction specified in internal units [rad].
@@ -1924,6 +2016,7 @@ public:
    * @param u Units
    */
   BandsRegion::Region regionOfHorizontalDirection(double dir, const std::string& u);
+  BandsRegion::Region regionOfHorizontalDirection(double dir, Unit u);
 
   /**
    * Return last time to direction maneuver, in seconds, for ownship with respect to traffic
@@ -1947,6 +2040,7 @@ public:
    * Return NaN if ac_idx is not a valid index.
    */
   double lastTimeToHorizontalDirectionManeuver(int ac_idx, const std::string& u);
+  double lastTimeToHorizontalDirectionManeuver(int ac_idx, Unit u);
 
   /**
    * @return recovery information for horizontal direction bands.
@@ -1986,6 +2080,7 @@ public:
    * is no resolution to the left.
    */
   double horizontalDirectionResolution(bool dir, const std::string& u);
+  double horizontalDirectionResolution(bool dir, Unit u);
 
   /**
    * Compute horizontal direction *raw* resolution maneuver for a given direction.
@@ -2009,6 +2104,7 @@ public:
    * is no resolution to the left.
    */
   double horizontalDirectionRawResolution(bool dir, const std::string& u);
+  double horizontalDirectionRawResolution(bool dir, Unit u);
 
   /**
    * Compute preferred horizontal direction based on resolution that is closer to current direction.
@@ -2039,6 +2135,7 @@ public:
    * @param u units
    */
   Interval horizontalSpeedIntervalAt(int i, const std::string& u);
+  Interval horizontalSpeedIntervalAt(int i, Unit u);
 
   /**
    * @return the i-th region of the computed horizontal speed bands.
@@ -2058,6 +2155,7 @@ public:
    * @param u Units
    */
   int indexOfHorizontalSpeed(double gs, const std::string& u);
+  int indexOfHorizontalSpeed(double gs, Unit u);
 
   /**
    * @return the region of a given horizontal speed specified in internal units [m/s]
@@ -2071,6 +2169,7 @@ public:
    * @param u Units
    */
   BandsRegion::Region regionOfHorizontalSpeed(double gs, const std::string& u);
+  BandsRegion::Region regionOfHorizontalSpeed(double gs, Unit u);
 
   /**
    * Return last time to horizontal speed maneuver, in seconds, for ownship with respect to traffic
@@ -2094,6 +2193,7 @@ public:
    * Return NaN if ac_idx is not a valid index.
    */
   double lastTimeToHorizontalSpeedManeuver(int ac_idx, const std::string& u);
+  double lastTimeToHorizontalSpeedManeuver(int ac_idx, Unit u);
 
   /**
    * @return recovery information for horizontal speed bands.
@@ -2133,6 +2233,7 @@ public:
    * is no down resolution.
    */
   double horizontalSpeedResolution(bool dir, const std::string& u);
+  double horizontalSpeedResolution(bool dir, Unit u);
 
   /**
    * Compute horizontal speed *raw* resolution maneuver.
@@ -2156,6 +2257,7 @@ public:
    * is no down resolution.
    */
   double horizontalSpeedRawResolution(bool dir, const std::string& u);
+  double horizontalSpeedRawResolution(bool dir, Unit u);
 
   /**
    * Compute preferred horizontal speed direction on resolution that is closer to current horizontal speed.
@@ -2186,6 +2288,7 @@ public:
    * @param u units
    */
   Interval verticalSpeedIntervalAt(int i, const std::string& u);
+  Interval verticalSpeedIntervalAt(int i, Unit u);
 
   /**
    * @return the i-th region of the computed vertical speed bands.
@@ -2205,6 +2308,7 @@ public:
    * @param u Units
    */
   int indexOfVerticalSpeed(double vs, const std::string& u);
+  int indexOfVerticalSpeed(double vs, Unit u);
 
   /**
    * @return the region of a given vertical speed specified in internal units [m/s]
@@ -2218,6 +2322,7 @@ public:
    * @param u Units
    */
   BandsRegion::Region regionOfVerticalSpeed(double vs, const std::string& u);
+  BandsRegion::Region regionOfVerticalSpeed(double vs, Unit u);
 
   /**
    * Return last time to vertical speed maneuver, in seconds, for ownship with respect to traffic
@@ -2241,6 +2346,7 @@ public:
    * Return NaN if ac_idx is not a valid index.
    */
   double lastTimeToVerticalSpeedManeuver(int ac_idx, const std::string& u);
+  double lastTimeToVerticalSpeedManeuver(int ac_idx, Unit u);
 
   /**
    * @return recovery information for vertical speed bands.
@@ -2280,6 +2386,7 @@ public:
    * is no down resolution.
    */
   double verticalSpeedResolution(bool dir, const std::string& u);
+  double verticalSpeedResolution(bool dir, Unit u);
 
   /**
    * Compute vertical speed *raw* resolution maneuver for given direction.
@@ -2303,6 +2410,7 @@ public:
    * is no down resolution.
    */
   double verticalSpeedRawResolution(bool dir, const std::string& u);
+  double verticalSpeedRawResolution(bool dir, Unit u);
 
   /**
    * Compute preferred  vertical speed direction based on resolution that is closer to current vertical speed.
@@ -2333,6 +2441,7 @@ public:
    * @param u units
    */
   Interval altitudeIntervalAt(int i, const std::string& u);
+  Interval altitudeIntervalAt(int i, Unit u);
 
 
   /**
@@ -2353,6 +2462,7 @@ public:
    * @param u Units
    */
   int indexOfAltitude(double alt, const std::string& u);
+  int indexOfAltitude(double alt, Unit u);
 
   /**
    * @return the region of a given altitude specified in internal units [m]
@@ -2366,6 +2476,7 @@ public:
    * @param u Units
    */
   BandsRegion::Region regionOfAltitude(double alt, const std::string& u);
+  BandsRegion::Region regionOfAltitude(double alt, Unit u);
 
   /**
    * Return last time to altitude maneuver, in seconds, for ownship with respect to traffic
@@ -2389,6 +2500,7 @@ public:
    * Return NaN if ac_idx is not a valid index.
    */
   double lastTimeToAltitudeManeuver(int ac_idx, const std::string& u);
+  double lastTimeToAltitudeManeuver(int ac_idx, Unit u);
 
   /**
    * @return recovery information for altitude speed bands.
@@ -2428,6 +2540,7 @@ public:
    * is no down resolution.
    */
   double altitudeResolution(bool dir, const std::string& u);
+  double altitudeResolution(bool dir, Unit u);
 
   /**
    * Compute altitude *raw* resolution maneuver for given direction.
@@ -2451,6 +2564,7 @@ public:
    * is no down resolution.
    */
   double altitudeRawResolution(bool dir, const std::string& u);
+  double altitudeRawResolution(bool dir, Unit u);
 
   /**
    * Compute preferred  altitude direction on resolution that is closer to current altitude.
@@ -2565,6 +2679,7 @@ public:
    * Returns NaN if aircraft index is not valid
    */
   double currentHorizontalSeparation(int ac_idx,const std::string& u) const;
+  double currentHorizontalSeparation(int ac_idx,Unit u) const;
 
   /**
    * Returns current vertical separation, in internal units, with aircraft at index ac_idx.
@@ -2577,6 +2692,7 @@ public:
    * Returns NaN if aircraft index is not valid
    */
   double currentVerticalSeparation(int ac_idx,const std::string& u) const;
+  double currentVerticalSeparation(int ac_idx,Unit u) const;
 
   /**
    * Returns horizontal closure rate, in internal units, with aircraft at index ac_idx.
@@ -2589,6 +2705,7 @@ public:
    * Returns NaN if aircraft index is not valid
    */
   double horizontalClosureRate(int ac_idx,const std::string& u) const;
+  double horizontalClosureRate(int ac_idx,Unit u) const;
 
   /**
    * Returns vertical closure rate, in internal units, with aircraft at index ac_idx.
@@ -2601,6 +2718,7 @@ public:
    * Returns NaN if aircraft index is not valid
    */
   double verticalClosureRate(int ac_idx,const std::string& u) const;
+  double verticalClosureRate(int ac_idx,Unit u) const;
 
   /**
    * Returns predicted HMD, in internal units, with aircraft at index ac_idx (up to lookahead time),
@@ -2613,6 +2731,7 @@ public:
    * assuming straight line trajectory. Returns NaN if aircraft index is not valid
    */
   double predictedHorizontalMissDistance(int ac_idx, const std::string& u) const;
+  double predictedHorizontalMissDistance(int ac_idx, Unit u) const;
 
   /**
    * Returns predicted VMD, in internal units, with aircraft at index ac_idx (up to lookahead time),
@@ -2626,6 +2745,7 @@ public:
    * assuming straight line trajectory. Return NaN if aircraft index is not valid
    */
   double predictedVerticalMissDistance(int ac_idx, const std::string& u) const;
+  double predictedVerticalMissDistance(int ac_idx, Unit u) const;
 
   /**
    * Returns time, in seconds, to horizontal closest point of approach with aircraft
@@ -2642,6 +2762,7 @@ public:
    * Returns NaN if aircraft index is not valid
    */
   double timeToHorizontalClosestPointOfApproach(int ac_idx, const std::string& u) const;
+  double timeToHorizontalClosestPointOfApproach(int ac_idx, Unit u) const;
 
   /**
    * Returns distance, in internal units, at horizontal closest point of approach with aircraft
@@ -2658,6 +2779,7 @@ public:
    * Returns NaN if aircraft index is not valid
    */
   double distanceAtHorizontalClosestPointOfApproach(int ac_idx, const std::string& u) const;
+  double distanceAtHorizontalClosestPointOfApproach(int ac_idx, Unit u) const;
 
   /**
    * Returns time, in seconds, to co-altitude with aircraft
@@ -2675,6 +2797,7 @@ public:
    * Returns NaN if aircraft index is not valid or if vertical closure is 0
    */
   double timeToCoAltitude(int ac_idx, const std::string& u) const;
+  double timeToCoAltitude(int ac_idx, Unit u) const;
 
   /**
    * Returns modified tau time, in seconds, for distance DMOD (given in internal units),
@@ -2691,6 +2814,69 @@ public:
    * Returns NaN if aircraft index is not valid or if vertical closure is 0
    */
   double modifiedTau(int ac_idx, double DMOD, const std::string& DMODu, const std::string& u) const;
+  double modifiedTau(int ac_idx, double DMOD, Unit DMODu, Unit u) const;
+
+  /* What-if queries */
+
+  /**
+   * Returns a hypothetical ownship state with the position of the current ownship and
+   * ground velocity vel. This state can be used in what-if queries. A what-if query
+   * evaluates a hypothetical ownship state against the current traffic aircraft without
+   * modifying aircraft states, cached values, or hysteresis information.
+   */
+  TrafficState hypotheticalOwnshipState(const Velocity& vel) const;
+
+  /**
+   * What-if query. Detects violation of alert thresholds for a given alert level between the
+   * hypothetical ownship state own and aircraft at index ac_idx.
+   * @param own is a hypothetical ownship state, e.g., computed with hypotheticalOwnshipState
+   * @param ac_idx is the index of the traffic aircraft
+   * @param alert_level alert level used to compute detection. The value 0
+   * indicate the alert volume of the corrective region.
+   */
+  ConflictData violationOfAlertThresholds(const TrafficState& own, int ac_idx, int alert_level) const;
+
+  /**
+   * What-if query. Detects violation of corrective thresholds between the hypothetical
+   * ownship state own and aircraft at index ac_idx.
+   * @param own is a hypothetical ownship state, e.g., computed with hypotheticalOwnshipState
+   * @param ac_idx is the index of the traffic aircraft
+   */
+  ConflictData violationOfCorrectiveThresholds(const TrafficState& own, int ac_idx) const;
+
+  /**
+   * What-if query. Returns time to corrective volume, in seconds, between the hypothetical ownship
+   * state own and aircraft at index ac_idx. POSITIVE_INFINITY means no conflict within lookahead time.
+   * NaN means aircraft index is out of range.
+   */
+  double timeToCorrectiveVolume(const TrafficState& own, int ac_idx) const;
+
+  /**
+   * What-if query. Returns time, in seconds, to horizontal closest point of approach between
+   * the hypothetical ownship state own and aircraft at index ac_idx, assuming straight line trajectory.
+   * If aircraft are diverging, the returned time is 0.
+   * Returns NaN if aircraft index is not valid
+   */
+  double timeToHorizontalClosestPointOfApproach(const TrafficState& own, int ac_idx) const;
+
+  /**
+   * Batched what-if query for a list of horizontal directions, in internal units [rad].
+   * For the k-th direction, a hypothetical ownship flying that direction, with the horizontal
+   * and vertical speeds of the ground velocity vel, is evaluated against all traffic aircraft.
+   * On return, tin[k] is the earliest time to corrective volume, in seconds, and tcpa[k] is the minimum
+   * time to horizontal closest point of approach, in seconds, among the aircraft in conflict.
+   * Both values are POSITIVE_INFINITY when the k-th direction is conflict free within lookahead time.
+   */
+  void horizontalDirectionConflicts(std::vector<double>& tin, std::vector<double>& tcpa,
+      const Velocity& vel, const std::vector<double>& dirs) const;
+
+  /**
+   * Batched what-if query for a list of horizontal directions, in given units [u].
+   * Same as above, but the current ownship's ground velocity provides the horizontal and
+   * vertical speeds of the hypothetical ownship.
+   */
+  void horizontalDirectionConflicts(std::vector<double>& tin, std::vector<double>& tcpa,
+      const std::vector<double>& dirs, const std::string& u) const;
 
   /* Input/Output methods */
 
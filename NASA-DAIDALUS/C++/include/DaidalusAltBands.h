@@ -43,6 +43,8 @@ public:
 
   virtual bool instantaneous_bands(const DaidalusParameters& parameters) const;
 
+  virtual bool shared_trajectory(const DaidalusParameters& parameters) const;
+
   virtual double own_val(const TrafficState& ownship) const;
 
   virtual double time_step(const DaidalusParameters& parameters, const TrafficState& ownship) const;
@@ -21,6 +21,7 @@
 #include <vector>
 #include <string>
 #include <cmath>
+#include <mutex>
 
 #include "HysteresisData.h"
 
@@ -40,6 +41,24 @@ public:
   Velocity wind_vector;
   DaidalusParameters parameters;
 
+  /**
+   * Structure-of-arrays view of the traffic list, indexed as traffic. Positions and velocities
+   * are the Euclidean projections, in internal units, of traffic aircraft with respect to the
+   * ownship. Uncertainties are the SUM standard deviations. Aircraft identifiers are given by
+   * their slots, i.e., interned identifiers.
+   */
+  struct TrafficArrays {
+    std::vector<double> sx, sy, sz;
+    std::vector<double> vx, vy, vz;
+    std::vector<double> s_EW_std, s_NS_std, s_EN_std, sz_std;
+    std::vector<double> v_EW_std, v_NS_std, v_EN_std, vz_std;
+    std::vector<int> slot;
+
+    int size() const;
+    void clear();
+    void push_back(const TrafficState& ac, int ac_slot);
+  };
+
   /* Strategy for most urgent aircraft */
   const UrgencyStrategy* get_urgency_strategy() const;
   bool set_urgency_strategy(const UrgencyStrategy* strat);
@@ -49,6 +68,9 @@ private:
   /* Strategy for most urgent aircraft */
   const UrgencyStrategy* urgency_strategy_;
 
+  /* Time stamps of the last time traffic aircraft states were set, indexed as traffic */
+  std::vector<double> traffic_update_time_;
+
   /**** CACHED VARIABLES ****/
 
   /* Variable to control re-computation of cached values */
@@ -74,15 +96,68 @@ private:
    * NaN means that bands are not computed for that region*/
   bool bands4region_[BandsRegion::NUMBER_OF_CONFLICT_BANDS];
 
+  /* Conflict detection between ownship and a traffic aircraft, for a given detector and time interval [B,T] */
+  struct CachedDetection {
+    const Detection3D* detector;
+    double B;
+    double T;
+    ConflictData det;
+  };
+  /* Cached conflict detections between ownship and traffic aircraft, indexed as traffic. Detections are
+   * computed at most once per detector and time interval until cached values are stale. */
+  std::vector<std::vector<CachedDetection> > detections_;
+  /* Cached detections may be requested concurrently when bands are computed in parallel */
+  std::mutex detections_mutex_;
+
+  /**** AIRCRAFT SLOTS ****/
+
+  // Aircraft identifiers are interned into dense slots the first time they are seen, so that
+  // per-aircraft data is accessed by index instead of by identifier
+  std::map<std::string,int> slots_;
+  // Identifier of the aircraft in each slot
+  std::vector<std::string> slot_ids_;
+  // 0-based index in traffic list of the aircraft in each slot (-1 if not in traffic list)
+  std::vector<int> slot_traffic_idx_;
+  // Slot of each aircraft, indexed as traffic
+  std::vector<int> traffic_slots_;
+  // Slot of ownship
+  int ownship_slot_;
+
+  /**** TRAFFIC ARRAYS ****/
+
+  // Structure-of-arrays copy of the traffic list. It is built on the first request after values
+  // become stale, which may happen concurrently from const methods
+  mutable TrafficArrays traffic_arrays_;
+  mutable bool traffic_arrays_fresh_;
+  mutable std::mutex traffic_arrays_mutex_;
+
   /**** HYSTERESIS VARIABLES ****/
 
-  // Alerting and DTA hysteresis per aircraft's ids
-  std::map<std::string,HysteresisData> alerting_hysteresis_acs_;
-  std::map<std::string,HysteresisData> dta_hysteresis_acs_;
+  // Alerting and DTA hysteresis per aircraft's slot. A hysteresis value is only defined
+  // for a slot when the corresponding flag is set.
+  std::vector<HysteresisData> alerting_hysteresis_acs_;
+  std::vector<bool> alerting_hysteresis_set_;
+  std::vector<HysteresisData> dta_hysteresis_acs_;
+  std::vector<bool> dta_hysteresis_set_;
 
   void copyFrom(const DaidalusCore& core);
   void refresh_mua_eps();
 
+  // Return slot of aircraft id. A new slot is created if id hasn't been seen before
+  int intern_slot(const std::string& id);
+
+  // Return slot of aircraft id (-1 if id hasn't been seen before)
+  int find_slot(const std::string& id) const;
+
+  // Clear hysteresis of given slot
+  void clear_slot_hysteresis(int slot);
+
+  // Remove slots of aircraft that are neither in the traffic list nor have hysteresis values
+  void compact_slots();
+
+  // Recompute slot_traffic_idx_ from traffic_slots_
+  void reindex_traffic_slots();
+
 public:
   DaidalusCore();
   virtual ~DaidalusCore() {};
@@ -123,6 +198,12 @@ public:
    */
   bool isFresh() const;
 
+  /**
+   * Returns structure-of-arrays view of the traffic list, indexed as traffic. The view
+   * is valid until the next time cached values become stale.
+   */
+  const TrafficArrays& traffic_arrays() const;
+
   /**
    *  Refresh cached values
    */
@@ -180,6 +261,12 @@ public:
 
   void set_ownship_state(const std::string& id, const Position& pos, const Velocity& vel, double time);
 
+  /**
+   * Incremental version of set_ownship_state. Traffic aircraft are kept, linearly projected to
+   * the new current time, and set as intruders of the new ownship. Requires time >= current_time.
+   */
+  void update_ownship_state(const std::string& id, const Position& pos, const Velocity& vel, double time);
+
   // Return 0-based index in traffic list (-1 if aircraft doesn't exist)
   int find_traffic_state(const std::string& id) const;
 
@@ -187,6 +274,14 @@ public:
   // nothing is done (e.g., id is the same as ownship's)
   int set_traffic_state(const std::string& id, const Position& pos, const Velocity& vel, double time);
 
+  // idx is 0-based index in traffic list. Update position and velocity of aircraft at idx, keeping
+  // its identifier, alerter, and SUM data. Return false if idx is out of range or state is not valid.
+  bool update_traffic_state(int idx, const Position& pos, const Velocity& vel, double time);
+
+  // Remove traffic aircraft whose states were last set before current_time-max_age.
+  // Return number of removed aircraft.
+  int remove_stale_traffic(double max_age);
+
   void reset_ownship(int idx);
 
   // idx is 0-based index in traffic list
@@ -217,6 +312,60 @@ public:
   int horizontal_hazard_zone(std::vector<Position>& haz, int idx, int alert_level,
       bool loss, bool from_ownship);
 
+  /**
+   * Returns a copy of the ownship state with ground velocity vel. The wind vector is applied
+   * to vel. The copy shares the Euclidean projection of the ownship. Therefore, it can be
+   * used with the current traffic states without projecting them again.
+   */
+  TrafficState ownship_with_velocity(const Velocity& vel) const;
+
+  /* idx is a 0-based index in the list of traffic aircraft
+   * Detection of alert thresholds for given alert level between own, a hypothetical ownship state,
+   * and the idx-th aircraft in the traffic list. An alert level 0 means the corrective alert level.
+   * This method doesn't modify cached values nor hysteresis variables.
+   * returns 1 if detector of traffic aircraft is not set
+   * returns 2 if corrective alerter level is not set
+   * returns 3 if alerter of traffic aircraft is out of bands
+   * otherwise, if there are no errors, returns 0 and the answer is in det
+   */
+  int violation_of_alert_thresholds(ConflictData& det, const TrafficState& own, int idx, int alert_level) const;
+
+  /**
+   * Conflict detection between ownship and the idx-th aircraft in the traffic list, using detector
+   * over the time interval [B,T]. The result is cached until cached values are stale, so that the same
+   * detection shared by alert levels, conflict regions, and bands is computed once. This method
+   * can be called concurrently.
+   * Requires 0 <= idx < traffic.size()
+   * INTERNAL USE ONLY
+   */
+  ConflictData conflict_detection(const Detection3D* detector, int idx, double B, double T);
+
+  /**
+   * Upper bound of the horizontal air speed of the ownship over all maneuvers considered by
+   * alerting and bands.
+   * INTERNAL USE ONLY
+   */
+  double max_ownship_speed() const;
+
+  /**
+   * Return true if the idx-th aircraft in the traffic list can't be in conflict with the ownship, using
+   * detector, within time T, when the horizontal air speed of the ownship is at most max_own_speed.
+   * This test is conservative and it's used to skip far away aircraft before detection.
+   * Requires 0 <= idx < traffic.size()
+   * INTERNAL USE ONLY
+   */
+  bool out_of_range(const Detection3D* detector, int idx, double max_own_speed, double T) const;
+
+  /**
+   * Batched what-if detection of corrective thresholds for a list of hypothetical ownship ground
+   * velocities. For the k-th velocity, tin[k] is the earliest time to violation of the corrective
+   * volume with any traffic aircraft and tcpa[k] is the minimum time to horizontal closest point of
+   * approach among the traffic aircraft in conflict. Both values are POSITIVE_INFINITY when there is no
+   * conflict. Alerters, detectors, and relative positions are resolved once per traffic aircraft and
+   * reused for all velocities. This method doesn't modify cached values nor hysteresis variables.
+   */
+  void corrective_conflicts(std::vector<double>& tin, std::vector<double>& tcpa, const std::vector<Velocity>& vels) const;
+
   /**
    * Computes alerting type of ownship and an the idx-th aircraft in the traffic list
    * The number 0 means no alert. A negative number means
@@ -238,18 +387,39 @@ public:
 
 private:
 
-  int dta_hysteresis_current_value(const TrafficState& ac);
+  int raw_dta_status(const TrafficState& ac) const;
+
+  // slot is the slot of aircraft ac
+  int dta_hysteresis_current_value(int slot, const TrafficState& ac);
+
+  // slot is the slot of aircraft ac (-1 if ac has no slot)
+  int dta_hysteresis_last_value(int slot, const TrafficState& ac) const;
+
+  // slot is the slot of intruder
+  int alerter_index_of(int slot, const TrafficState& intruder);
 
-  int alerting_hysteresis_current_value(const TrafficState& intruder, int turning, int accelerating, int climbing);
+  // slot is the slot of intruder (-1 if intruder has no slot)
+  int current_alerter_index_of(int slot, const TrafficState& intruder) const;
+
+  // slot is the slot of intruder
+  int alerting_hysteresis_current_value(int slot, const TrafficState& intruder, int turning, int accelerating, int climbing);
 
   bool greater_than_corrective() const;
 
-  int raw_alert_level(const Alerter& alerter, const TrafficState& intruder, int turning, int accelerating, int climbing);
+  // slot is the slot of intruder
+  double alerting_time_of(const Alerter& alerter, int alert_level, int slot) const;
+
+  // slot is the slot of intruder
+  bool nested_alert_levels(const Alerter& alerter, int slot) const;
+
+  // slot is the slot of intruder
+  int raw_alert_level(const Alerter& alerter, int slot, const TrafficState& intruder, int turning, int accelerating, int climbing);
 
   /**
    * Return true if and only if threshold values, defining an alerting level, are violated.
+   * slot is the slot of intruder.
    */
-  bool check_alerting_thresholds(const Alerter& alerter, int alert_level, const TrafficState& intruder, int turning, int accelerating, int climbing);
+  bool check_alerting_thresholds(const Alerter& alerter, int alert_level, int slot, const TrafficState& intruder, int turning, int accelerating, int climbing);
 
   /**
    * Requires 0 <= conflict_region < CONFICT_BANDS
@@ -281,10 +451,24 @@ public:
    * If ownship centric, it returns the alert index of ownship.
    * Otherwise, returns the alert index of the intruder.
    * If the DTA logic is enabled, the alerter of an aircraft is determined by
-   * its dta status.
+   * its dta status. If the aircraft is neither the ownship nor a traffic aircraft
+   * seen before, its raw dta status is used and no hysteresis is created for it.
    */
   int alerter_index_of(const TrafficState& intruder);
 
+  /**
+   * Same as alerter_index_of, where idx is a 0-based index in the list of traffic aircraft.
+   * Requires 0 <= idx < traffic.size()
+   */
+  int traffic_alerter_index(int idx);
+
+  /**
+   * Same as alerter_index_of, but DTA hysteresis is not updated. If DTA hysteresis
+   * was already applied at current time, its last value is used. Otherwise, the raw DTA
+   * status of the aircraft is used.
+   */
+  int current_alerter_index_of(const TrafficState& intruder) const;
+
   static int epsilonH(const TrafficState& ownship, const TrafficState& ac);
 
   static int epsilonV(const TrafficState& ownship, const TrafficState& ac);
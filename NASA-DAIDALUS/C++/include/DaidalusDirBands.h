@@ -50,6 +50,12 @@ public:
 
   virtual double max_delta_resolution(const DaidalusParameters& parameters) const;
 
+  virtual bool instantaneous_critical_steps(std::vector<double>& steps, const Detection3D* det, double B, double T,
+      bool trajdir, const DaidalusParameters& parameters, const TrafficState& ownship, const TrafficState& traffic) const;
+
+private:
+  TrafficState instantaneous_ownship(const TrafficState& ownship, double trk) const;
+
 };
 
 }
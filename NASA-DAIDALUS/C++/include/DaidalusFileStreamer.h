@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2015-2021 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+/*
+ * DaidalusFileStreamer.h
+ *
+ */
+
+#ifndef DAIDALUSFILESTREAMER_H_
+#define DAIDALUSFILESTREAMER_H_
+
+#include "SeparatedInput.h"
+#include "ParameterData.h"
+#include "ErrorLog.h"
+#include "ErrorReporter.h"
+#include "Daidalus.h"
+#include "Position.h"
+#include "Velocity.h"
+#include <fstream>
+#include <vector>
+#include <string>
+#include <map>
+
+namespace larcfm {
+
+/**
+ * Objects of class DaidalusFileStreamer walk forward through the time steps of a daa file, reading
+ * one time step at a time. Contrary to DaidalusFileWalker, which loads the whole file in memory
+ * and supports random access to time steps, the memory used by a streamer is bounded by the size of
+ * one time step. Therefore, this class is intended for long recorded encounters. Lines of the daa
+ * file are expected to be sorted by time. A line whose time is before the current time step is
+ * skipped and reported as an error. For daa files sorted by time, readState sets the same states,
+ * in the same order, as DaidalusFileWalker.
+ */
+class DaidalusFileStreamer : public ErrorReporter {
+private:
+
+  /* State of one aircraft at a time step, as read from one line of the file */
+  class Entry {
+  public:
+    std::string name;
+    Position pos;
+    Velocity vel;
+    ParameterData extra; // Values of extra columns
+    int order; // Order of first appearance of aircraft in file
+    Entry();
+    bool operator<(const Entry& entry) const;
+  };
+
+  // Indices of columns in head_
+  static const int NAME = 0;
+  static const int LAT_SX = 1;
+  static const int LON_SY = 2;
+  static const int ALT_SZ = 3;
+  static const int TRK_VX = 4;
+  static const int GS_VY = 5;
+  static const int VS_VZ = 6;
+  static const int TM_CLK = 7;
+  static const int DEFINED_COLUMNS = 8;
+
+  std::ifstream in_;
+  SeparatedInput input_;
+  mutable ErrorLog error_;
+  bool header_read_;
+  bool latlon_;
+  bool clock_;
+  bool trkgsvs_;
+  std::vector<int> head_; // Column indices of defined columns followed by extra columns
+  std::map<std::string,int> names_; // Order of first appearance of aircraft read so far
+  std::string last_name_;
+  std::vector<Entry> step_; // Aircraft at current time step
+  double time_;
+  int index_;
+  Entry next_; // First line of next time step
+  double next_time_;
+  bool has_next_;
+  std::string ownship_; // Set ownship to a given value
+  std::vector<std::string> traffic_; // Only consider the traffic aircraft
+
+  DaidalusFileStreamer(const DaidalusFileStreamer& dfs);
+  DaidalusFileStreamer& operator=(const DaidalusFileStreamer& dfs);
+
+  void init(const std::string& filename);
+  int altHeadings(const std::string& s1, const std::string& s2, const std::string& s3, const std::string& s4) const;
+  bool readHeader();
+  bool readEntry(Entry& entry, double& tm);
+  void readStep();
+
+public:
+
+  /**
+   * Open daa file and read its first time step. Errors are reported through the ErrorReporter interface.
+   */
+  explicit DaidalusFileStreamer(const std::string& filename);
+
+  /**
+   * Open a new daa file and read its first time step. Selection of ownship and traffic is preserved.
+   */
+  void resetInputFile(const std::string& filename);
+
+  /**
+   * By default ownship is the first aircraft in the daa file.
+   * This method allows for the selection of a different aircraft as the ownship
+   * If aircraft with given name doesn't exist at a time step, no ownship or traffic
+   * is added to the Daidalus object at that particular time step.
+   */
+  void setOwnship(const std::string& name);
+
+  /**
+   * Returns the name of the ownship.
+   * An empty string refers to the aircraft that is the first in the daa file
+   */
+  const std::string& getOwnship() const;
+
+  /**
+   * Reset the ownship value so that the first aircraft in the daa are considered
+   * the ownship.
+   */
+  void resetOwnship();
+
+  /**
+   * By default all aircraft that are not the ownship are considered to be traffic.
+   * This method add a particular aircraft to the list of selected aircraft.
+   * Several aircraft can be selected, but if the list of selected aircraft is non empty,
+   * only the aircraft in the list are considered traffic.
+   */
+  void selectTraffic(const std::string& name);
+
+  /**
+   * By default all aircraft that are not the ownship are considered to be traffic.
+   * This method add a list of aircraft to the list of selected aircraft.
+   * Several aircraft can be selected, but if the list of selected aircraft is non empty,
+   * only the aircraft in the list are considered traffic.
+   */
+  void selectTraffic(const std::vector<std::string>& names);
+
+  /**
+   * Returns the list of selected traffic. An empty list means that all aircraft that are
+   * not the ownship are considered traffic.
+   */
+  const std::vector<std::string>& getSelectedTraffic() const;
+
+  /**
+   * Reset the list of selected aircraft so that all aircraft that are not ownship are
+   * considered traffic.
+   */
+  void resetSelectedTraffic();
+
+  /**
+   * Returns the number of time steps read before the current one.
+   */
+  int getIndex() const;
+
+  /**
+   * Returns the time of the current time step, or NaN if at end of file.
+   */
+  double getTime() const;
+
+  bool atBeginning() const;
+
+  bool atEnd() const;
+
+  /**
+   * Read the next time step. The current time step is discarded.
+   */
+  void goNext();
+
+  /**
+   * Go forward to the last time step whose time is less than or equal to t, as DaidalusFileWalker::goToTime
+   * does. Return false if t is before the current time step, since a streamer can't go back, or after
+   * the last time step of the file.
+   */
+  bool goToTime(double t);
+
+  /**
+   * Set states of current time step in daa and read the next time step.
+   */
+  void readState(Daidalus& daa);
+
+  bool hasError() const;
+
+  bool hasMessage() const;
+
+  std::string getMessage();
+
+  std::string getMessageNoClear() const;
+
+};
+
+}
+
+#endif /* DAIDALUSFILESTREAMER_H_ */
@@ -117,6 +117,12 @@ public:
 
   static void readExtraColumns(Daidalus& daa, const SequenceReader& sr, int ac_idx);
 
+  /**
+   * Set parameters, alerter, and uncertainty of aircraft at index ac_idx from the values of
+   * the extra columns in pcol.
+   */
+  static void readExtraColumns(Daidalus& daa, const ParameterData& pcol, int ac_idx);
+
   void readState(Daidalus& daa);
   bool hasError() const;
 
@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2015-2021 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+#ifndef DAIDALUSFLEET_H_
+#define DAIDALUSFLEET_H_
+
+#include "Daidalus.h"
+#include "DaidalusResults.h"
+#include "Position.h"
+#include "Velocity.h"
+#include "Vect3.h"
+#include <vector>
+#include <string>
+#include <map>
+
+namespace larcfm {
+
+/**
+ * Objects of class DaidalusFleet compute alerting and bands for all designated ownships of a
+ * traffic picture. States of all aircraft are provided once per time step. Then, compute() evaluates
+ * every designated ownship against every other aircraft, concurrently in the thread pool shared by
+ * all Daidalus objects (see DaidalusThreadPool), and keeps a compact summary of the results per
+ * ownship. Every ownship keeps its own Daidalus object across time steps, so hysteresis and
+ * persistence logic work as in a single Daidalus object. While no aircraft is added or removed,
+ * the traffic list of these objects is updated in place (see Daidalus::updateOwnshipState and
+ * Daidalus::updateTrafficState) instead of being rebuilt. Resolutions are only summarized for the
+ * dimensions that are enabled, and a full DaidalusResults snapshot of an ownship is only computed
+ * on request. Pairwise geometric quantities, i.e., relative position and
+ * velocity, time to horizontal closest point of approach, and predicted horizontal miss distance,
+ * are computed on request in the Euclidean projection centered at the first aircraft, so they are the
+ * same as the ones computed by the Daidalus object of that aircraft.
+ */
+class DaidalusFleet {
+
+public:
+
+  /**
+   * Compact results of the last computation for one ownship.
+   */
+  class Summary {
+  public:
+    /* Maximum alert level with respect to all other aircraft. It's 0 if there is no alert, and -1
+     * if the aircraft is not a designated ownship */
+    int alert_level;
+    /* Identifier of the aircraft with maximum alert level and earliest time to corrective volume.
+     * It's empty if there is no alert */
+    std::string alerting_ac;
+    /* Earliest time to corrective volume, in seconds, with respect to all other aircraft. It's
+     * POSITIVE_INFINITY if there is no conflict within lookahead time */
+    double time_to_corrective_volume;
+    /* Resolutions in internal units, indexed by direction, i.e., [0]: left/down, [1]: right/up. They
+     * are NaN if resolutions of the dimension are not enabled in the fleet */
+    double horizontal_direction_resolution[2];
+    double horizontal_speed_resolution[2];
+    double vertical_speed_resolution[2];
+    double altitude_resolution[2];
+    Summary();
+  };
+
+private:
+
+  class Aircraft {
+  public:
+    std::string id;
+    Position pos;
+    Velocity vel;
+    double time;
+    bool ownship;
+    Aircraft(const std::string& id, const Position& pos, const Velocity& vel, double time, bool ownship);
+  };
+
+  class Engine {
+  public:
+    Daidalus daa;
+    long roster; // Roster of the traffic list of daa, -1 if it doesn't contain all other aircraft
+    explicit Engine(const Daidalus& config);
+  };
+
+  Daidalus config_; // Configuration copied to the Daidalus object of every ownship
+  std::vector<Aircraft> aircraft_;
+  std::map<std::string,int> aircraft_idx_;
+  long roster_; // Changes every time an aircraft is added or removed
+  std::map<std::string,Engine> engines_; // Daidalus object of every designated ownship
+  std::map<std::string,int> computed_idx_; // Index of aircraft at last computation
+  std::vector<Aircraft> computed_; // Aircraft at last computation, projected to current time
+  std::vector<Summary> summaries_; // Summaries of last computation, indexed as computed_
+  double current_time_;
+  bool parallel_;
+  bool direction_resolutions_;
+  bool hs_resolutions_;
+  bool vs_resolutions_;
+  bool alt_resolutions_;
+
+  void update_engine(Engine& engine, int i, const std::vector<Position>& pos) const;
+  void summarize(Summary& summary, Daidalus& daa) const;
+  bool relative_state(Vect3& s, Vect3& v, const std::string& id1, const std::string& id2) const;
+
+public:
+
+  /**
+   * Construct an empty fleet with default Daidalus configuration.
+   */
+  DaidalusFleet();
+
+  /**
+   * Construct an empty fleet where every ownship is configured as daa. Only configuration
+   * parameters and wind of daa are used. Aircraft states in daa are ignored.
+   */
+  explicit DaidalusFleet(const Daidalus& daa);
+
+  /**
+   * Set configuration of every ownship. Only configuration parameters and wind of daa are used.
+   * Since Daidalus objects of ownships are re-created, hysteresis is cleared.
+   */
+  void setConfiguration(const Daidalus& daa);
+
+  /**
+   * Return configuration of ownships.
+   */
+  const Daidalus& getConfiguration() const;
+
+  /**
+   * Enable/disable parallel computation of ownships. Ownships are computed by the thread pool shared
+   * by all Daidalus objects, whose number of threads is set via DaidalusThreadPool::shared().setNumberOfThreads(n).
+   * Parallel computation is enabled by default.
+   */
+  void setParallel(bool flag);
+
+  /**
+   * Return true if ownships are computed in parallel.
+   */
+  bool isParallel() const;
+
+  /**
+   * Enable/disable horizontal direction resolutions in summaries. Resolutions are disabled by default,
+   * since they require the computation of bands.
+   */
+  void setHorizontalDirectionResolutions(bool flag);
+
+  /**
+   * Return true if horizontal direction resolutions are computed for summaries.
+   */
+  bool isEnabledHorizontalDirectionResolutions() const;
+
+  /**
+   * Enable/disable horizontal speed resolutions in summaries. Resolutions are disabled by default.
+   */
+  void setHorizontalSpeedResolutions(bool flag);
+
+  /**
+   * Return true if horizontal speed resolutions are computed for summaries.
+   */
+  bool isEnabledHorizontalSpeedResolutions() const;
+
+  /**
+   * Enable/disable vertical speed resolutions in summaries. Resolutions are disabled by default.
+   */
+  void setVerticalSpeedResolutions(bool flag);
+
+  /**
+   * Return true if vertical speed resolutions are computed for summaries.
+   */
+  bool isEnabledVerticalSpeedResolutions() const;
+
+  /**
+   * Enable/disable altitude resolutions in summaries. Resolutions are disabled by default.
+   */
+  void setAltitudeResolutions(bool flag);
+
+  /**
+   * Return true if altitude resolutions are computed for summaries.
+   */
+  bool isEnabledAltitudeResolutions() const;
+
+  /**
+   * Set state of aircraft at given time. If the aircraft already exists, its state is replaced.
+   * If ownship is true, alerting and bands are computed for this aircraft.
+   * @return number of aircraft in the fleet after the state is set
+   */
+  int setAircraftState(const std::string& id, const Position& pos, const Velocity& vel, double time, bool ownship);
+
+  /**
+   * Same as setAircraftState(id,pos,vel,time,true).
+   */
+  int setAircraftState(const std::string& id, const Position& pos, const Velocity& vel, double time);
+
+  /**
+   * Remove aircraft with given identifier. Return true if aircraft was removed.
+   */
+  bool removeAircraft(const std::string& id);
+
+  /**
+   * Remove all aircraft.
+   */
+  void clear();
+
+  /**
+   * Return number of aircraft in the fleet.
+   */
+  int numberOfAircraft() const;
+
+  /**
+   * Return true if aircraft with given identifier is in the fleet.
+   */
+  bool hasAircraft(const std::string& id) const;
+
+  /**
+   * Return true if alerting and bands are computed for aircraft with given identifier.
+   */
+  bool isOwnship(const std::string& id) const;
+
+  /**
+   * Compute alerting and bands for every designated ownship with respect to all other aircraft.
+   * States are projected to the latest time stamp of all aircraft, which is the current time of
+   * the computation.
+   */
+  void compute();
+
+  /**
+   * Return current time of last computation.
+   */
+  double getCurrentTime() const;
+
+  /**
+   * Return true if aircraft with given identifier is a designated ownship at last computation, i.e.,
+   * if it has a summary.
+   */
+  bool hasSummary(const std::string& id) const;
+
+  /**
+   * Return summary of last computation for aircraft with given identifier. If the aircraft doesn't
+   * have a summary (see hasSummary), return an empty summary, whose alert level is -1, alerting
+   * aircraft is empty, time to corrective volume is POSITIVE_INFINITY, and resolutions are NaN.
+   */
+  const Summary& getSummary(const std::string& id) const;
+
+  /**
+   * Return full results of last computation for ownship with given identifier. The snapshot is taken
+   * from the Daidalus object of the ownship on request, so its cost is the one of DaidalusResults. If
+   * the aircraft is not a designated ownship, return an empty snapshot, i.e., a snapshot without ownship.
+   */
+  DaidalusResults getResults(const std::string& id);
+
+  /**
+   * Return relative position s_1 - s_2, in internal units [m], of aircraft id1 with respect to aircraft id2
+   * at last computation. Return invalid vector if any of the aircraft is not in the last computation.
+   */
+  Vect3 relativePosition(const std::string& id1, const std::string& id2) const;
+
+  /**
+   * Return relative velocity v_1 - v_2, in internal units [m/s], of aircraft id1 with respect to aircraft id2
+   * at last computation. Return invalid vector if any of the aircraft is not in the last computation.
+   */
+  Vect3 relativeVelocity(const std::string& id1, const std::string& id2) const;
+
+  /**
+   * Return time, in seconds, to horizontal closest point of approach between aircraft id1 and id2
+   * at last computation. If aircraft are diverging, the returned time is 0. Return NaN if any of the
+   * aircraft is not in the last computation.
+   */
+  double timeToHorizontalClosestPointOfApproach(const std::string& id1, const std::string& id2) const;
+
+  /**
+   * Return predicted horizontal miss distance, in internal units [m], between aircraft id1 and id2
+   * (up to lookahead time) at last computation. Return NaN if any of the aircraft is not in the last
+   * computation.
+   */
+  double predictedHorizontalMissDistance(const std::string& id1, const std::string& id2) const;
+
+};
+
+}
+
+#endif
@@ -19,6 +19,8 @@
 
 #include <vector>
 #include <string>
+#include <atomic>
+#include <mutex>
 #include "TrafficState.h"
 
 namespace larcfm {
@@ -28,7 +30,28 @@ class DaidalusIntegerBands {
 
   // This class computes NONE bands
 
+private:
+  // Kinematic trajectory of traj_ownship_ at times k*traj_tstep_, where traj_s_[dir][k] and traj_v_[dir][k] are
+  // position and velocity in direction dir (0: left/down, 1: right/up). Trajectories are shared by all traffic aircraft.
+  // The table is built by the first kinematic search that needs it, which may run in any thread of the pool.
+  const DaidalusParameters* traj_parameters_;
+  const TrafficState* traj_ownship_;
+  double traj_tstep_;
+  int traj_max_[2];
+  mutable std::vector<Vect3> traj_s_[2];
+  mutable std::vector<Velocity> traj_v_[2];
+  mutable std::atomic<bool> traj_built_;
+  mutable std::mutex traj_mutex_;
+
+  void build_trajectory_table(const TrafficState& ownship) const;
+
 public:
+  DaidalusIntegerBands();
+
+  // The trajectory table is not copied
+  DaidalusIntegerBands(const DaidalusIntegerBands& b);
+
+  DaidalusIntegerBands& operator=(const DaidalusIntegerBands& b);
   // trajdir == false is left/down
   // target_step is used by instantaneous_bands and altitude_bands
   virtual std::pair<Vect3,Velocity> trajectory(const DaidalusParameters& parameters, const TrafficState& ownship,
@@ -36,6 +59,31 @@ public:
 
   virtual ~DaidalusIntegerBands() {}
 
+  /*
+   * Enable a table of kinematic trajectories of ownship at times k*tstep, for k in [0,maxl+1] to the left/down and
+   * for k in [0,maxr+1] to the right/up. The table is only computed when a kinematic search first needs it. Until
+   * clear_trajectory_table is called, these trajectories are used instead of calling trajectory when the ownship
+   * state is the same object. Parameters and ownship have to outlive the table.
+   */
+  void tabulate_trajectory(const DaidalusParameters& parameters, const TrafficState& ownship, double tstep, int maxl, int maxr);
+
+  void clear_trajectory_table();
+
+  /*
+   * Same as trajectory, but kinematic trajectories of ownship at time steps are taken from the trajectory table
+   * when available.
+   */
+  std::pair<Vect3,Velocity> ownship_trajectory(const DaidalusParameters& parameters, const TrafficState& ownship,
+      double time, bool dir, int target_step, bool instantaneous) const;
+
+  /*
+   * Add to steps the target steps, which may be fractional, where the conflict status with respect to det between
+   * times B and T may change in instantaneous bands. Return false if these steps are not known analytically,
+   * which is the default. In that case, the conflict status is checked at every step.
+   */
+  virtual bool instantaneous_critical_steps(std::vector<double>& steps, const Detection3D* det, double B, double T,
+      bool trajdir, const DaidalusParameters& parameters, const TrafficState& ownship, const TrafficState& traffic) const;
+
   /*
    * In PVS: int_bands@CD_future_traj
    */
@@ -60,6 +108,9 @@ public:
       const DaidalusParameters& parameters, const TrafficState& ownship, const TrafficState& traffic, int target_step, bool instantaneous) const;
 
 private:
+  // Number of instantaneous steps checked at once by searches that may stop early
+  static const int INSTANTANEOUS_BATCH = 32;
+
   // In PVS: int_bands@first_los_step
   int kinematic_first_los_step(const Detection3D* det, double tstep, bool trajdir,
       int min, int max, const DaidalusParameters& parameters, const TrafficState& ownship, const TrafficState& traffic) const;
@@ -121,11 +172,34 @@ private:
       bool trajdir, int max, const DaidalusParameters& parameters, const TrafficState& ownship, const TrafficState& traffic,
       int epsh, int epsv) const;
 
+  bool instantaneous_repulsive(bool trajdir, const DaidalusParameters& parameters, const TrafficState& ownship, const TrafficState& traffic,
+      int epsh, int epsv, int target_step) const;
+
   //In PVS: inst_bands@conflict_free_track_step, inst_bands@conflict_free_gs_step, inst_bands@conflict_free_vs_step
   bool no_instantaneous_conflict(const Detection3D* conflict_det, const Detection3D* recovery_det, double B, double T,
       bool trajdir, const DaidalusParameters& parameters, const TrafficState& ownship, const TrafficState& traffic,
       int epsh, int epsv, int target_step) const;
 
+  // Set free[k] to true if there is no conflict between times B and T with respect to det, for the instantaneous
+  // maneuver to target step min+k, where owns[k] is the ownship state after that maneuver.
+  void instantaneous_no_CD_steps(std::vector<bool>& free, const Detection3D* det, double B, double T,
+      const DaidalusParameters& parameters, const std::vector<TrafficState>& owns, const TrafficState& traffic) const;
+
+  // Set free[k-min] to no_instantaneous_conflict(...,k), for k in [min,max]. Since instantaneous maneuvers that
+  // keep the ownship position only change its velocity, the steps are checked with one call to
+  // conflictDetectionWithTrafficStates per detector.
+  void instantaneous_no_conflict_steps(std::vector<bool>& free, const Detection3D* conflict_det, const Detection3D* recovery_det,
+      double B, double T,
+      bool trajdir, int min, int max, const DaidalusParameters& parameters, const TrafficState& ownship, const TrafficState& traffic,
+      int epsh, int epsv) const;
+
+  // Set green[k] to no_instantaneous_conflict(...,k), for k in [0,max], using critical steps. Return false if critical steps
+  // are not available.
+  bool instantaneous_green_steps(std::vector<bool>& green, const Detection3D* conflict_det, const Detection3D* recovery_det,
+      double B, double T,
+      bool trajdir, int max, const DaidalusParameters& parameters, const TrafficState& ownship, const TrafficState& traffic,
+      int epsh, int epsv) const;
+
   //In PVS: int_bands@nat_bands, int_bands@nat_bands_rec
   void instantaneous_bands(std::vector<Integerval>& l,
       const Detection3D* conflict_det, const Detection3D* recovery_det, double B, double T,
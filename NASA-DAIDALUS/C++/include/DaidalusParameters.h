@@ -15,6 +15,7 @@
 
 #include <map>
 #include <vector>
+#include <memory>
 
 namespace larcfm {
 
@@ -22,7 +23,9 @@ class DaidalusParameters : public ErrorReporter, public ParameterAcceptor {
 
 private:
 
-  std::vector<Alerter> alerters_;
+  // Alerters are shared by copies of these parameters, e.g., parameters loaded by loadSharedFromFile,
+  // and they are only copied when modified
+  std::shared_ptr<std::vector<Alerter> > alerters_;
 
   ErrorLog error;
 
@@ -147,6 +150,17 @@ private:
    */
   void set_alerters_with_SUM_parameters();
 
+  /*
+   * Return alerters for modification. Alerters are copied first if they are shared.
+   */
+  std::vector<Alerter>& mutable_alerters();
+
+  /*
+   * Return true if global SUM parameters, which are used by alerters with WCV_TAUMOD_SUM detectors,
+   * are the same in these parameters and in p.
+   */
+  bool same_global_SUM_parameters(const DaidalusParameters& p) const;
+
 public:
 
   /**
@@ -892,6 +906,15 @@ public:
    */
   bool loadFromFile(const std::string& file);
 
+  /**
+   *  Update current parameters with parameters from file, as loadFromFile. Files are parsed once per process,
+   *  unless they are modified. Alerters defined in the file, including their detectors, are shared by all
+   *  parameters loaded from the same file and by their copies, e.g., copies of a Daidalus object. Shared
+   *  alerters are copied when they are modified through these parameters, so sharing is not observable.
+   *  Return false if file can't be read.
+   */
+  bool loadSharedFromFile(const std::string& file);
+
   /**
    *  Write parameters to file.
    */
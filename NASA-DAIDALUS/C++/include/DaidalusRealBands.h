@@ -45,6 +45,7 @@ private:
   // When mod_ > 0, min_rel, max_rel in [0,mod_/2]
   double min_rel_; // Relative min value. A negative value represents val-min, i.e., from val to min
   double max_rel_; // Relative max value. A negative value represents max-val, i.e., from val to max
+  bool parallel_; // True if none bands of different aircraft are computed in parallel
 
   /**** CACHED VARIABLES ****/
 
@@ -112,6 +113,10 @@ public:
 
   virtual bool instantaneous_bands(const DaidalusParameters& parameters) const = 0;
 
+  // Return true if kinematic bands are computed from ownship trajectories at time steps that are shared by all
+  // traffic aircraft. This is the case for kinematic bands, except altitude bands.
+  virtual bool shared_trajectory(const DaidalusParameters& parameters) const;
+
   virtual double max_delta_resolution(const DaidalusParameters& parameters) const = 0;
 
   virtual bool saturate_corrective_bands(const DaidalusParameters& parameters, int dta_status) const;
@@ -132,6 +137,17 @@ public:
    */
   void set_min_max_rel(double min_rel, double max_rel);
 
+  /**
+   * Enable/disable parallel computation of none bands of different aircraft. Parallel computation
+   * uses the thread pool shared by all Daidalus objects.
+   */
+  void set_parallel(bool flag);
+
+  /**
+   * Return true if none bands of different aircraft are computed in parallel.
+   */
+  bool is_parallel() const;
+
 private:
   double min_rel(const DaidalusParameters& parameters) const;
 
@@ -219,6 +235,15 @@ private:
    */
   void saturateNoneIntervalSet(IntervalSet& noneset) const;
 
+  /**
+   * Compute in noneset the none bands for aircraft in ilt. Uses aircraft detector if parameter
+   * detector is none. Return false if the alerter of the aircraft is out of bounds, in which case
+   * the aircraft doesn't contribute to the bands.
+   */
+  bool aircraft_none_bands(IntervalSet& noneset, const IndexLevelT& ilt,
+      Detection3D* det, Detection3D* recovery,
+      bool recovery_case, double B, DaidalusCore& core) const;
+
   /**
    * Compute none bands for a const std::vector<IndexLevelT>& ilts of IndexLevelT in none_set_region.
    * The none_set_region is initiated as a saturated green band.
@@ -229,6 +254,16 @@ private:
       Detection3D* det, Detection3D* recovery,
       bool recovery_case, double B, DaidalusCore& core);
 
+  /**
+   * Parallel version of compute_none_bands. This is a fork-join over aircraft: one task per aircraft
+   * is pushed into the FIFO queue of DaidalusThreadPool, idle threads (including the caller) take the
+   * next task, and the caller waits for all of them. There is no per-thread queue nor work stealing.
+   * None bands are intersected in the same order as in the sequential version.
+   */
+  void compute_none_bands_parallel(IntervalSet& none_set_region, const std::vector<IndexLevelT>& ilts,
+      Detection3D* det, Detection3D* recovery,
+      bool recovery_case, double B, DaidalusCore& core) const;
+
   /**
    * Compute recovery bands. Class variables recovery_time_, recovery_horizontal_distance_,
    * and recovery_vertical_distance_ are set.
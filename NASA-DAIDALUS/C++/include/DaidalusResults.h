@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2015-2021 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+#ifndef DAIDALUSRESULTS_H_
+#define DAIDALUSRESULTS_H_
+
+#include "TrafficState.h"
+#include "BandsRange.h"
+#include "BandsRegion.h"
+#include "Interval.h"
+#include "RecoveryInformation.h"
+#include "Units.h"
+#include <vector>
+#include <string>
+#include <map>
+
+namespace larcfm {
+
+class Daidalus;
+class DaidalusRealBands;
+
+/**
+ * Immutable snapshot of the alerting and banding results of a Daidalus object at a given time.
+ * A snapshot is created by Daidalus::snapshot(), which computes all results once. Since all methods
+ * of this class are const and don't have side effects, a snapshot can be queried concurrently by
+ * any number of threads without locks, while the Daidalus object is updated with new states.
+ * Indices of aircraft and regions follow the same conventions as in the Daidalus interface.
+ */
+class DaidalusResults {
+
+private:
+
+  /* Results of bands in one dimension */
+  class Bands {
+  public:
+    std::vector<BandsRange> ranges;
+    double mod; // If mod > 0, bands are circular modulo this value
+    double resolution[2]; // 0: left/down, 1: right/up
+    double raw_resolution[2];
+    bool preferred;
+    RecoveryInformation recovery;
+    // List of aircraft contributing to peripheral bands, where 0th:FAR, 1th:MID, 2th:NEAR
+    std::vector<std::vector<std::string> > peripheral_acs;
+    // Last time to maneuver, indexed as traffic aircraft
+    std::vector<double> last_time_to_maneuver;
+
+    Bands();
+
+    int length() const;
+    Interval interval(int i) const;
+    Interval interval(int i, const std::string& u) const;
+    Interval interval(int i, Unit u) const;
+    BandsRegion::Region region(int i) const;
+    int indexOf(double val) const;
+    void peripheralAircraft(std::vector<std::string>& acs, int region) const;
+    double lastTimeToManeuver(int ac_idx) const;
+  };
+
+  double current_time_;
+  std::vector<TrafficState> aircraft_; // Ownship followed by traffic aircraft
+  std::map<std::string,int> aircraft_idx_; // Index of aircraft by identifier
+  std::vector<int> alert_levels_; // Indexed as aircraft
+  std::vector<double> time_to_corrective_volume_; // Indexed as aircraft
+  // List of aircraft contributing to conflict bands, where 0th:FAR, 1th:MID, 2th:NEAR
+  std::vector<std::vector<std::string> > conflict_acs_;
+  std::vector<Interval> time_interval_of_conflict_; // 0th:FAR, 1th:MID, 2th:NEAR
+  int dta_status_;
+  Bands hdir_;
+  Bands hs_;
+  Bands vs_;
+  Bands alt_;
+
+  void snapshotBands(Bands& bands, DaidalusRealBands& band, Daidalus& daa);
+
+public:
+
+  /**
+   * Construct an empty snapshot, i.e., without ownship.
+   */
+  DaidalusResults();
+
+  /**
+   * Construct a snapshot of the current results of daa. Bands in all dimensions are computed,
+   * concurrently if parallel bands are enabled in daa.
+   */
+  explicit DaidalusResults(Daidalus& daa);
+
+  /**
+   * @return current time in seconds of the snapshot
+   */
+  double getCurrentTime() const;
+
+  /**
+   * @return true if snapshot has an ownship
+   */
+  bool hasOwnship() const;
+
+  /**
+   * @return number of aircraft, including ownship.
+   */
+  int numberOfAircraft() const;
+
+  /**
+   * @return last traffic index. Every traffic aircraft has an index between 1 and lastTrafficIndex.
+   */
+  int lastTrafficIndex() const;
+
+  /**
+   * Get index of aircraft with given name. Return -1 if no such index exists
+   */
+  int aircraftIndex(const std::string& name) const;
+
+  /**
+   * Get state of aircraft at index idx. The ownship is at index 0.
+   */
+  const TrafficState& getAircraftStateAt(int idx) const;
+
+  /**
+   * @return alert level of aircraft at index ac_idx, without ownship maneuver assumptions.
+   * A negative number means that aircraft index is not valid.
+   */
+  int alertLevel(int ac_idx) const;
+
+  /**
+   * @return time to corrective volume, in seconds, between ownship and aircraft at index ac_idx.
+   * POSITIVE_INFINITY means no conflict within lookahead time. NaN means aircraft index is out of range.
+   */
+  double timeToCorrectiveVolume(int ac_idx) const;
+
+  /**
+   * Compute in acs list of aircraft identifiers contributing to conflict bands for given
+   * conflict bands region. 1 = FAR, 2 = MID, 3 = NEAR.
+   */
+  void conflictBandsAircraft(std::vector<std::string>& acs, int region) const;
+
+  void conflictBandsAircraft(std::vector<std::string>& acs, BandsRegion::Region region) const;
+
+  /**
+   * Return time interval of violation for given conflict bands region. 1 = FAR, 2 = MID, 3 = NEAR
+   */
+  Interval timeIntervalOfConflict(int region) const;
+
+  Interval timeIntervalOfConflict(BandsRegion::Region region) const;
+
+  /**
+   * Return true if DTA logic is active
+   */
+  bool isActiveDTALogic() const;
+
+  /**
+   * Return true if DTA special maneuver guidance is active
+   */
+  bool isActiveDTASpecialManeuverGuidance() const;
+
+  /* Horizontal direction bands, in internal units [rad] unless otherwise specified */
+
+  int horizontalDirectionBandsLength() const;
+  Interval horizontalDirectionIntervalAt(int i) const;
+  Interval horizontalDirectionIntervalAt(int i, const std::string& u) const;
+  Interval horizontalDirectionIntervalAt(int i, Unit u) const;
+  BandsRegion::Region horizontalDirectionRegionAt(int i) const;
+  int indexOfHorizontalDirection(double dir) const;
+  BandsRegion::Region regionOfHorizontalDirection(double dir) const;
+  double horizontalDirectionResolution(bool dir) const;
+  double horizontalDirectionRawResolution(bool dir) const;
+  bool preferredHorizontalDirectionRightOrLeft() const;
+  RecoveryInformation horizontalDirectionRecoveryInformation() const;
+  void peripheralHorizontalDirectionBandsAircraft(std::vector<std::string>& acs, int region) const;
+  double lastTimeToHorizontalDirectionManeuver(int ac_idx) const;
+
+  /* Horizontal speed bands, in internal units [m/s] unless otherwise specified */
+
+  int horizontalSpeedBandsLength() const;
+  Interval horizontalSpeedIntervalAt(int i) const;
+  Interval horizontalSpeedIntervalAt(int i, const std::string& u) const;
+  Interval horizontalSpeedIntervalAt(int i, Unit u) const;
+  BandsRegion::Region horizontalSpeedRegionAt(int i) const;
+  int indexOfHorizontalSpeed(double gs) const;
+  BandsRegion::Region regionOfHorizontalSpeed(double gs) const;
+  double horizontalSpeedResolution(bool dir) const;
+  double horizontalSpeedRawResolution(bool dir) const;
+  bool preferredHorizontalSpeedUpOrDown() const;
+  RecoveryInformation horizontalSpeedRecoveryInformation() const;
+  void peripheralHorizontalSpeedBandsAircraft(std::vector<std::string>& acs, int region) const;
+  double lastTimeToHorizontalSpeedManeuver(int ac_idx) const;
+
+  /* Vertical speed bands, in internal units [m/s] unless otherwise specified */
+
+  int verticalSpeedBandsLength() const;
+  Interval verticalSpeedIntervalAt(int i) const;
+  Interval verticalSpeedIntervalAt(int i, const std::string& u) const;
+  Interval verticalSpeedIntervalAt(int i, Unit u) const;
+  BandsRegion::Region verticalSpeedRegionAt(int i) const;
+  int indexOfVerticalSpeed(double vs) const;
+  BandsRegion::Region regionOfVerticalSpeed(double vs) const;
+  double verticalSpeedResolution(bool dir) const;
+  double verticalSpeedRawResolution(bool dir) const;
+  bool preferredVerticalSpeedUpOrDown() const;
+  RecoveryInformation verticalSpeedRecoveryInformation() const;
+  void peripheralVerticalSpeedBandsAircraft(std::vector<std::string>& acs, int region) const;
+  double lastTimeToVerticalSpeedManeuver(int ac_idx) const;
+
+  /* Altitude bands, in internal units [m] unless otherwise specified */
+
+  int altitudeBandsLength() const;
+  Interval altitudeIntervalAt(int i) const;
+  Interval altitudeIntervalAt(int i, const std::string& u) const;
+  Interval altitudeIntervalAt(int i, Unit u) const;
+  BandsRegion::Region altitudeRegionAt(int i) const;
+  int indexOfAltitude(double alt) const;
+  BandsRegion::Region regionOfAltitude(double alt) const;
+  double altitudeResolution(bool dir) const;
+  double altitudeRawResolution(bool dir) const;
+  bool preferredAltitudeUpOrDown() const;
+  RecoveryInformation altitudeRecoveryInformation() const;
+  void peripheralAltitudeBandsAircraft(std::vector<std::string>& acs, int region) const;
+  double lastTimeToAltitudeManeuver(int ac_idx) const;
+
+};
+
+}
+
+#endif
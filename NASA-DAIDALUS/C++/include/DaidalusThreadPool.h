@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2015-2021 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+#ifndef DAIDALUSTHREADPOOL_H_
+#define DAIDALUSTHREADPOOL_H_
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace larcfm {
+
+/**
+ * Pool of worker threads shared by all Daidalus objects in the process. It is used to run
+ * independent computations, e.g., bands in different dimensions, concurrently.
+ * The pool has no worker threads by default, in which case all tasks are run sequentially
+ * in the calling thread.
+ */
+class DaidalusThreadPool {
+
+private:
+
+  class Batch;
+
+  class Job {
+  public:
+    const std::function<void()>* task;
+    Batch* batch;
+    Job(const std::function<void()>* t, Batch* b);
+  };
+
+  std::vector<std::thread> workers_;
+  std::deque<Job> jobs_;
+  std::mutex mutex_;
+  std::condition_variable jobs_cv_;
+  bool stopping_;
+
+  DaidalusThreadPool();
+  DaidalusThreadPool(const DaidalusThreadPool& pool);
+  DaidalusThreadPool& operator=(const DaidalusThreadPool& pool);
+
+  void stop_workers();
+  void work();
+  void execute(const Job& job);
+
+public:
+
+  ~DaidalusThreadPool();
+
+  /**
+   * Return the thread pool shared by all Daidalus objects.
+   */
+  static DaidalusThreadPool& shared();
+
+  /**
+   * Set number of worker threads. A value less than or equal to 0 removes all worker threads, in which
+   * case tasks are run sequentially in the calling thread. This method waits until running tasks
+   * are done and it shouldn't be called from a task.
+   */
+  void setNumberOfThreads(int n);
+
+  /**
+   * Return number of worker threads.
+   */
+  int getNumberOfThreads();
+
+  /**
+   * Run all tasks and return when all of them are done. Tasks are run concurrently by the worker
+   * threads and the calling thread. Tasks may call this method, i.e., nested batches are allowed.
+   */
+  void run(const std::vector<std::function<void()> >& tasks);
+
+};
+
+}
+
+#endif
@@ -22,6 +22,8 @@
 #include "string_util.h"
 #include "ParameterAcceptor.h"
 #include <string>
+#include <vector>
+#include <deque>
 
 namespace larcfm {
 
@@ -102,6 +104,55 @@ public:
    */
   virtual ConflictData conflictDetectionWithTrafficState(const TrafficState& ownship, const TrafficState& intruder, double B, double T) const;
 
+  /**
+   * Batched version of conflictDetection for one intruder and a list of ownship velocities. On return,
+   * dets[k] is the same as conflictDetection(so,vos[k],si,vi,B,T). Subclasses may override this method
+   * to reuse computations that don't depend on the ownship velocity.
+   * @param dets  list of ConflictData objects, indexed as vos
+   * @param so    ownship position
+   * @param vos   list of ownship velocities
+   * @param si    intruder position
+   * @param vi    intruder velocity
+   * @param B     beginning of detection time (>=0)
+   * @param T     end of detection time (if T < 0 then use an "infinite" lookahead time)
+   */
+  virtual void conflictDetectionVelocities(std::vector<ConflictData>& dets, const Vect3& so, const std::vector<Velocity>& vos,
+      const Vect3& si, const Velocity& vi, double B, double T) const;
+
+  /**
+   * Batched version of conflictDetectionWithTrafficState for one intruder and a list of ownship states
+   * that only differ in their velocities. On return, dets[k] is the same as
+   * conflictDetectionWithTrafficState(owns[k],intruder,B,T).
+   * @param dets      list of ConflictData objects, indexed as owns
+   * @param owns      list of ownship states with the same position
+   * @param intruder  intruder state
+   * @param B   beginning of detection time (>=0)
+   * @param T   end of detection time (if T < 0 then use an "infinite" lookahead time)
+   */
+  virtual void conflictDetectionWithTrafficStates(std::vector<ConflictData>& dets, const std::vector<TrafficState>& owns,
+      const TrafficState& intruder, double B, double T) const;
+
+  /**
+   * Add to trks the compass angles of the unit vectors u where the conflict status between times B and T (0 <= B < T)
+   * may change, when the ownship velocity is co + r*u in the horizontal plane and co.z in the vertical plane, i.e., when
+   * the ownship only changes direction. The conflict status is the same for all directions between two consecutive angles.
+   * @param co  center of ownship velocities
+   * @param r   radius of ownship velocities, i.e., ground speed
+   * @return false if this detector doesn't support the computation of critical angles, which is the default. In that case,
+   * the conflict status has to be checked direction by direction.
+   */
+  virtual bool horizontalCriticalTracks(std::vector<double>& trks, const Vect3& so, const Velocity& co, double r, const Vect3& si, const Velocity& vi,
+      double B, double T) const;
+
+  /**
+   * Return a horizontal distance R such that two aircraft are not in violation at a time t when their horizontal
+   * distance at t is greater than R, provided that their horizontal relative speed at t is at most vh. Aircraft
+   * whose horizontal distance is greater than R + vh*T can't be in conflict within lookahead time T.
+   * @return POSITIVE_INFINITY if no such distance is known, which is the default. In that case, no aircraft
+   * is skipped.
+   */
+  virtual double horizontalViolationRange(double vh) const;
+
   /** This returns a pointer to a new instance of this type of Detector3D.  You are responsible for destroying this instance when it is no longer needed. */
   virtual Detection3D* copy() const = 0;
   virtual Detection3D* make() const = 0;
@@ -175,7 +226,35 @@ public:
       double T) const;
 
 private:
-  static void add_blob(std::vector<std::vector<Position> >& blobs, std::vector<Position>& vin, std::vector<Position>& vout);
+  static void add_blob(std::vector<std::vector<Position> >& blobs, std::deque<Position>& vin, std::deque<Position>& vout);
+
+  // Put in crit the sorted list of directions, relative to the direction of vo and in [0,2pi), where the conflict
+  // status between times 0 and T may change when the ownship air velocity is vo with a different direction.
+  // Return false if critical directions are not supported by this detector.
+  bool contour_critical_directions(std::vector<double>& crit, const TrafficState& ownship, const Velocity& vo,
+      const TrafficState& intruder, double T) const;
+
+  // Detections between 0 and T for the directions visited by the contour sweep to one side (sign is 1 for right and
+  // -1 for left) of the current direction, where the i-th direction is i degrees away from the current direction.
+  struct ContourSweep {
+    double sign;
+    double next; // Direction, relative to the current direction, of the first detection that hasn't been computed
+    std::vector<ConflictData> dets;
+    explicit ContourSweep(double s) : sign(s), next(0.0) {}
+  };
+
+  // Compute, through conflictDetectionWithTrafficStates, the detections of sweep for the next batch of directions
+  // including the i-th one.
+  void contour_sweep_batch(ContourSweep& sweep, TrafficState& own, const Velocity& vo, const TrafficState& intruder,
+      double T, int i) const;
+
+  // Conflict detection between 0 and T for own with air velocity vop, whose direction is x relative to the current
+  // direction and is the i-th direction of sweep. If critical directions are available, i.e., cell_status is not
+  // empty, the detection is skipped for directions known to be conflict free. Otherwise, the detection is taken
+  // from sweep, which is computed in batches as the sweep advances. The air velocity of own is only set when a
+  // detection is performed. Return true if there is a conflict, in which case los is set.
+  bool contour_conflict(LossData& los, TrafficState& own, const Velocity& vo, const Velocity& vop, const TrafficState& intruder,
+      double T, double x, ContourSweep& sweep, int i, const std::vector<double>& crit, std::vector<int>& cell_status) const;
 };
 
 inline Detection3D::~Detection3D(){}
@@ -13,7 +13,7 @@
 #define HYSTERESISDATA_H_
 
 #include "MofN.h"
-#include <deque>
+#include <string>
 
 namespace larcfm {
 
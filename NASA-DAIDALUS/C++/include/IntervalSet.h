@@ -49,12 +49,19 @@ namespace larcfm {
  * }
  * </code></pre><p>
  *
- * The current implementation does not allocate any dynamic (heap) memory.
+ * Small sets are stored in the IntervalSet object itself. Heap memory is only
+ * allocated when a set has more than inline_intervals intervals.
  */
 class IntervalSet {// : ErrorReporter {
 
 public:
-	/** The maximum number of intervals */
+	/** The number of intervals stored without allocating heap memory */
+	static const int inline_intervals = 8;
+
+	/**
+	 * \deprecated {Sets no longer have a maximum number of intervals. This is the former maximum, kept
+	 * so that code that refers to it still compiles.}
+	 */
 	static const int max_intervals = 400;
 
 public:
@@ -66,6 +73,11 @@ public:
 	 * */ 
 	IntervalSet(const IntervalSet& l);
 
+	/** Copy the IntervalSet l into this set
+	 * @param l IntervalSet to copy
+	 * */
+	IntervalSet& operator=(const IntervalSet& l);
+
 	/** Build an IntervalSet from the given vector */
 	explicit IntervalSet(const std::vector<Interval>& v);
 
@@ -223,10 +235,14 @@ private:
 	void insert(int i, const Interval& r);
 	void remove(int i);
 	void remove(int i, int len);
+	void reserve(int n);
 
 	static const Interval empty;
-	Interval r[max_intervals];
+	Interval* r; // Points to inline_r or to heap_r
 	int length;
+	int capacity;
+	Interval inline_r[inline_intervals];
+	std::vector<Interval> heap_r;
 };
 
 }
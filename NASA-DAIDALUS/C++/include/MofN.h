@@ -12,7 +12,7 @@
 #ifndef MOFN_H_
 #define MOFN_H_
 
-#include <deque>
+#include <vector>
 #include <string>
 
 namespace larcfm {
@@ -67,10 +67,24 @@ public:
   std::string toString() const;
 
 private:
+  // Number of values stored inline. Larger values of n (queue) or max (counts) spill to the heap.
+  static const int inline_size = 8;
+
   int m_;
   int n_;
   int    max_;
-  std::deque<int> queue_;
+  // Ring buffer of the last n values, from the oldest one at head_
+  int head_;
+  int inline_queue_[inline_size];
+  std::vector<int> heap_queue_;
+  // count[i] is the number of values in the queue that are equal to i, for 0 <= i <= max_
+  int inline_count_[inline_size];
+  std::vector<int> heap_count_;
+
+  int* queue();
+  const int* queue() const;
+  int* count();
+  void reserve_count(int max);
 
 };
 
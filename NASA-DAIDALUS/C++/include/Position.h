@@ -87,6 +87,12 @@ public:
 	 */
 	static Position makeLatLonAlt(double lat, std::string lat_unit, double lon, std::string lon_unit, double alt, std::string alt_unit);
 
+	/**
+	 * Creates a new lat/lon position with coordinates (<code>lat</code>,<code>lon</code>,<code>alt</code>) in
+	 * typed units, e.g., units::deg.
+	 */
+	static Position makeLatLonAlt(double lat, Unit lat_unit, double lon, Unit lon_unit, double alt, Unit alt_unit);
+
 
 	/**
 	 * Creates a new lat/lon position with coordinates (<code>lat</code>,<code>lon</code>,<code>alt</code>).
@@ -133,6 +139,12 @@ public:
 	 */
 	static Position makeXYZ(double x, std::string x_unit, double y, std::string y_unit, double z, std::string z_unit);
 
+	/**
+	 * Creates a new Euclidean position with coordinates (<code>x</code>,<code>y</code>,<code>z</code>) in
+	 * typed units, e.g., units::NM.
+	 */
+	static Position makeXYZ(double x, Unit x_unit, double y, Unit y_unit, double z, Unit z_unit);
+
 	/** Construct a new Position object from a LatLonAlt object. The position will be a Lat/Lon position. 
 	 * 
 	 * @param lla a latitude/longitude/altitude object
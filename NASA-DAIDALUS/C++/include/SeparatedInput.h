@@ -317,6 +317,8 @@ namespace larcfm {
     bool first_bunits;          // units line read in
     std::vector<std::string> units_str;     // Units type
     std::vector<double> units_factor;  // Units conversion value
+    mutable std::vector<std::string> default_str;   // Default unit last requested for columns without units
+    mutable std::vector<double> default_factor;     // Conversion value of default unit
     std::vector<std::string> line_str;      // raw line
 
     bool fixed_width;    // Instead of using a delimiter, use fixed width columns
@@ -339,9 +341,11 @@ namespace larcfm {
     ParameterData parameters;
     
     double getUnitFactor(int i) const;
+    double getDefaultUnitFactor(int i, const std::string& default_unit) const;
     bool process_units(const std::string& str);
     bool process_preamble(std::string str);
     void process_line(const std::string& str);
+    void split_line(const std::string& str, std::vector<std::string>& fields) const;
 	
     std::vector<std::string> processQuotes(const std::string& str) const; 
 	std::string readFullLine(std::istream* reader);  
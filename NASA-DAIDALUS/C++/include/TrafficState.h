@@ -96,6 +96,12 @@ public:
    */
   void setAsIntruderOf(const TrafficState& ownship);
 
+  /**
+   * Set position to new_pos and ground velocity to new_gvel, keeping the wind vector, and set
+   * aircraft as intruder of ownship. Identifier, alerter, and SUM data are kept.
+   */
+  void setStateAsIntruderOf(const Position& new_pos, const Velocity& new_gvel, const TrafficState& ownship);
+
   /**
    * Make intruder aircraft
    * @param id Intruder's identifier
@@ -28,6 +28,22 @@ double _FormalATM_gn();
 /** See Units::P0 */
 double _FormalATM_P0();
 
+/**
+ * Unit whose conversion factor to internal units is one of the constants in Units, e.g., Units::deg.
+ * Typed units, which are defined in namespace units, are an alternative to unit strings in code that is
+ * executed often, since they don't need to be parsed, e.g., Units::from(units::knot,250.0).
+ */
+class Unit {
+public:
+  constexpr explicit Unit(const double& f) : factor_(&f) {}
+  /** Conversion factor to internal units */
+  double factor() const {
+    return *factor_;
+  }
+private:
+  const double* factor_;
+};
+
 
 
 /**
@@ -473,6 +489,14 @@ public:
 	static double from(const double symbol, const double value);
 	/** Convert the value from the given units into internal units */
 	static double from(const std::string& units, double value);
+	/** Convert the value in internal units to the given typed units */
+	static double to(const Unit u, const double value) {
+	  return value / u.factor();
+	}
+	/** Convert the value from the given typed units into internal units */
+	static double from(const Unit u, const double value) {
+	  return value * u.factor();
+	}
 	static double fromInternal(const std::string& defaultUnits, const std::string& units, double value);
 
 	/** Get the unit conversion factor for the given string unit */
@@ -552,6 +576,30 @@ public:
 
 };
 
+/**
+ * Typed units. Temperature units, whose conversion is not a factor, are not typed.
+ */
+namespace units {
+
+constexpr Unit m(Units::m);
+constexpr Unit km(Units::km);
+constexpr Unit NM(Units::NM);
+constexpr Unit nmi(Units::nmi);
+constexpr Unit ft(Units::ft);
+constexpr Unit s(Units::s);
+constexpr Unit hour(Units::hour);
+constexpr Unit rad(Units::rad);
+constexpr Unit deg(Units::deg);
+constexpr Unit mps(Units::mps);
+constexpr Unit kph(Units::kph);
+constexpr Unit knot(Units::knot);
+constexpr Unit kn(Units::kn);
+constexpr Unit fpm(Units::fpm);
+constexpr Unit fps(Units::foot_per_second);
+constexpr Unit mps2(Units::meter_per_second2);
+
+}
+
 }
 
 #endif /* UNITS_H_ */
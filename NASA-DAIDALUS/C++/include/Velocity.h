@@ -218,6 +218,12 @@ public:
 	static Velocity makeVxyz(const double vx, const double vy, const std::string& uvxy,
 			const double vz, const std::string& uvz);
 
+	/**
+	 * New velocity from Euclidean coordinates in explicit typed units, e.g., units::knot.
+	 */
+	static Velocity makeVxyz(const double vx, const double vy, const Unit uvxy,
+			const double vz, const Unit uvz);
+
 	/**
 	 * New velocity from Track, Ground Speed, and Vertical speed in internal units.
 	 * Note that this uses trigonometric functions, and may introduce numeric instability.
@@ -261,6 +267,14 @@ public:
 			const double gs, const std::string& ugs,
 			const double vs, const std::string& uvs);
 
+	/**
+	 * New velocity from Track, Ground Speed, and Vertical speed in explicit typed units, e.g., units::deg.
+	 * Note that this uses trigonometric functions, and may introduce numeric instability.
+	 */
+	static Velocity makeTrkGsVs(const double trk, const Unit utrk,
+			const double gs, const Unit ugs,
+			const double vs, const Unit uvs);
+
 	/**
 	 * Return the velocity along the line from p1 to p2 at the given speed
 	 * @param p1 first point
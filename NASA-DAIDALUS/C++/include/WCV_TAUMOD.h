@@ -72,6 +72,9 @@ public:
 
   virtual LossData horizontal_WCV_interval(double T, const Vect2& s, const Vect2& v) const ;
 
+  virtual bool horizontalCriticalTracks(std::vector<double>& trks, const Vect3& so, const Velocity& co, double r, const Vect3& si, const Velocity& vi,
+      double B, double T) const;
+
   virtual Detection3D* make() const;
 
   /**
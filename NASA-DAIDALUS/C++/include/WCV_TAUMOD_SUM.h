@@ -57,6 +57,28 @@ public:
   virtual ConflictData conflictDetectionWithTrafficState(const TrafficState& ownship, const TrafficState& intruder,
       double B, double T) const;
 
+  /**
+   * Uncertainty terms, relative position, and the tangent directions of the position uncertainty only
+   * depend on the positions, which are the same for all ownship states, so they are computed once.
+   * The vertical interval of violation is computed once for consecutive states with the same
+   * vertical speed. Through Detection3D, this method is used by instantaneous bands, which includes
+   * the spread checks of the alerting logic when bands are instantaneous, by horizontal contours, since
+   * critical tracks are not supported, and by corrective conflicts.
+   */
+  virtual void conflictDetectionWithTrafficStates(std::vector<ConflictData>& dets, const std::vector<TrafficState>& owns,
+      const TrafficState& intruder, double B, double T) const;
+
+  /**
+   * Critical angles are not supported when the aircraft states have uncertainty.
+   */
+  virtual bool horizontalCriticalTracks(std::vector<double>& trks, const Vect3& so, const Velocity& co, double r, const Vect3& si, const Velocity& vi,
+      double B, double T) const;
+
+  /**
+   * Violation volume grows with the uncertainty of the aircraft states, so no range is known.
+   */
+  virtual double horizontalViolationRange(double vh) const;
+
 private:
 
   double  h_pos_z_score_;          // Number of horizontal position standard deviations
@@ -91,21 +113,31 @@ private:
 
   std::pair<Vect2,Vect2> optimal_pair(const Vect2& v1, const Vect2& v2, const Vect2& w1, const Vect2& w2) const;
 
+  // Unit directions of the lines through the origin that are tangent to the circle of radius s_err around s
+  std::pair<Vect2,Vect2> position_tangents(const Vect2& s, double s_err) const;
+
   std::pair<Vect2,Vect2> optimal_wcv_pair_comp_init(const Vect2& v1, const Vect2& v2, double s_err, double v_err) const;
 
+  std::pair<Vect2,Vect2> optimal_wcv_pair_comp_init(const std::pair<Vect2,Vect2>& s_tangents, const Vect2& v, double v_err) const;
+
   std::pair<Vect2,Vect2> optimal_wcv_pair(const Vect2& s, const Vect2& v, double s_err, double v_err, int eps1, int eps2) const;
 
+  std::pair<Vect2,Vect2> optimal_wcv_pair(const std::pair<Vect2,Vect2>& s_tangents, const Vect2& s, const Vect2& v, double s_err, double v_err, int eps1, int eps2) const;
+
   bool horizontal_wcv_taumod_uncertain(const Vect2& s, const Vect2& v, double s_err, double v_err) const;
 
   bool vertical_WCV_uncertain(double sz, double vz, double sz_err, double vz_err) const;
 
-  double horizontal_wcv_taumod_uncertain_entry(const Vect2& s, const Vect2& v, double s_err, double v_err, double T) const;
+  // If s_tangents is not NULL, it's position_tangents(s,s_err)
+  double horizontal_wcv_taumod_uncertain_entry(const Vect2& s, const Vect2& v, double s_err, double v_err, double T,
+      const std::pair<Vect2,Vect2>* s_tangents=NULL) const;
 
   double Theta_D_uncertain(const Vect2& s, const Vect2& v, double s_err, double v_err, int eps) const;
 
   double horizontal_wcv_taumod_uncertain_exit(const Vect2& s, const Vect2& v,double s_err, double v_err, double T) const;
 
-  LossData horizontal_wcv_taumod_uncertain_interval(const Vect2& s, const Vect2& v,double s_err, double v_err, double T) const;
+  LossData horizontal_wcv_taumod_uncertain_interval(const Vect2& s, const Vect2& v,double s_err, double v_err, double T,
+      const std::pair<Vect2,Vect2>* s_tangents=NULL) const;
 
   LossData vertical_WCV_uncertain_full_interval_szpos_vzpos(double T, double minsz/*,double maxsz*/, double minvz/*, double maxvz*/) const;
 
@@ -117,6 +149,10 @@ private:
 
   LossData vertical_WCV_uncertain_interval(double B, double T, double sz, double vz, double sz_err, double vz_err) const;
 
+  // Time interval of violation given the vertical interval of violation vint and relative horizontal state s,v
+  LossData WCV_taumod_uncertain_interval(const LossData& vint, double B, double T, const Vect2& s, const Vect2& v,
+      double s_err, double v_err, const std::pair<Vect2,Vect2>* s_tangents) const;
+
   bool containsSUM(WCV_TAUMOD_SUM* wcv) const;
 
   double relativeHorizontalPositionError(const TrafficState& own, const TrafficState& ac) const;
@@ -26,6 +26,9 @@ protected:
 
   void copyFrom(const WCV_tvar& core);
 
+  // Time interval of violation given the vertical interval of violation ii and relative horizontal state s2,v2
+  LossData WCV_interval(const Interval& ii, const Vect2& s2, const Vect2& v2, double B, double T) const;
+
 public:
 
   WCV_tvar& operator=(const WCV_tvar& core);
@@ -75,6 +78,20 @@ public:
 
   LossData WCV_interval(const Vect3& so, const Velocity& vo, const Vect3& si, const Velocity& vi, double B, double T) const;
 
+  /**
+   * Batched conflict detection for a list of ownship velocities. The vertical interval of violation only
+   * depends on the vertical speed, so it is computed once for consecutive velocities with the same vertical speed,
+   * e.g., when the ownship only changes direction or horizontal speed.
+   */
+  virtual void conflictDetectionVelocities(std::vector<ConflictData>& dets, const Vect3& so, const std::vector<Velocity>& vos,
+      const Vect3& si, const Velocity& vi, double B, double T) const;
+
+  /**
+   * Horizontal violation at time t requires either a horizontal distance of at most DTHR or that the aircraft
+   * reach DTHR within TTHR, so the horizontal distance at t is at most DTHR + TTHR*vh.
+   */
+  virtual double horizontalViolationRange(double vh) const;
+
   bool containsTable(WCV_tvar* wcv) const;
 
   virtual std::string toString() const;
@@ -20,6 +20,8 @@
 #include <cmath>
 
 #include "CD3D.h"
+#include "CriticalVectors2D.h"
+#include "TangentLine.h"
 #include "format.h"
 
 namespace larcfm {
@@ -148,6 +150,64 @@ ConflictData CDCylinder::conflictDetection(const Vect3& so, const Velocity& vo,
   return conflict_detection(so,vo,si,vi,D_,H_,B,T);
 }
 
+void CDCylinder::conflictDetectionVelocities(std::vector<ConflictData>& dets, const Vect3& so, const std::vector<Velocity>& vos,
+    const Vect3& si, const Velocity& vi, double B, double T) const {
+  dets.clear();
+  dets.reserve(vos.size());
+  Vect3 s = so.Sub(si);
+  for (std::vector<Velocity>::const_iterator vo_ptr = vos.begin(); vo_ptr != vos.end(); ++vo_ptr) {
+    const Velocity& vo = *vo_ptr;
+    Vect3 v = vo.Sub(vi);
+    double t_tca = CD3D::tccpa(s, vo, vi, D_, H_, B, T);
+    double dist_tca = s.linear(v,t_tca).cyl_norm(D_, H_);
+    LossData ld = CD3D::detection(s,vo,vi,D_,H_,B,T);
+    dets.push_back(ConflictData(ld,t_tca,dist_tca,s,v));
+  }
+}
+
+// The conflict status changes when the relative position crosses the D circle at the times where the vertical
+// interval begins and ends, or when the horizontal miss distance reaches D.
+bool CDCylinder::horizontalCriticalTracks(std::vector<double>& trks, const Vect3& so, const Velocity& co, double r, const Vect3& si, const Velocity& vi,
+    double B, double T) const {
+  if (B < 0 || B >= T) {
+    return true;
+  }
+  Vect3 s = so.Sub(si);
+  double t1 = B;
+  double t2 = T;
+  if (!Util::almost_equals(co.z,vi.z)) {
+    double vz = co.z-vi.z;
+    t1 = Util::max(Vertical::Theta_H(s.z,vz,larcfm::Entry,H_),B);
+    t2 = Util::min(Vertical::Theta_H(s.z,vz,larcfm::Exit,H_),T);
+  } else if (!Vertical::almost_vertical_los(s.z,H_)) {
+    return true;
+  }
+  if (t1 >= t2) {
+    return true;
+  }
+  Vect2 s2 = s.vect2();
+  Vect2 w = co.vect2().Sub(vi.vect2());
+  double c = s2.sqv()-Util::sq(D_);
+  CriticalVectors2D::circleTracks(trks,w,r,Util::sq(t1),s2.Scal(2*t1),c);
+  CriticalVectors2D::circleTracks(trks,w,r,Util::sq(t2),s2.Scal(2*t2),c);
+  if (Horizontal::horizontal_sep(s2,D_)) {
+    for (int eps=-1;eps <= 1; eps+=2) {
+      TangentLine nv(s2,D_,eps);
+      CriticalVectors2D::circleTracks(trks,w,r,0,nv.PerpR(),0);
+    }
+  }
+  // Zero relative velocity
+  if (!w.isZero()) {
+    trks.push_back(w.Neg().compassAngle());
+  }
+  return true;
+}
+
+// Horizontal violation requires a horizontal distance less than D
+double CDCylinder::horizontalViolationRange(double vh) const {
+  return D_;
+}
+
 double CDCylinder::time_of_closest_approach(const Vect3& so, const Velocity& vo, const Vect3& si, const Velocity& vi, double D, double H, double B, double T) {
   return CD3D::tccpa(so.Sub(si),vo,vi,D,H,B,T);
 }
@@ -238,15 +238,15 @@ int CriteriaCore::breakSymmetry(const Vect3& s, std::string ownship, std::string
 }
 
 static bool trkChanged(Velocity vo, Velocity nvo) {
-  return std::abs(vo.trk() - nvo.trk()) > Units::from("deg",0.001);
+  return std::abs(vo.trk() - nvo.trk()) > Units::from(units::deg,0.001);
 }
 
 static bool gsChanged(Velocity vo, Velocity nvo) {
-  return std::abs(vo.gs() - nvo.gs()) > Units::from("kn",0.001);
+  return std::abs(vo.gs() - nvo.gs()) > Units::from(units::kn,0.001);
 }
 
 static bool vsChanged(Velocity vo, Velocity nvo) {
-  return std::abs(vo.vs() - nvo.vs()) > Units::from("fpm",0.001);
+  return std::abs(vo.vs() - nvo.vs()) > Units::from(units::fpm,0.001);
 }
 
 bool CriteriaCore::criteria(const Vect3& s, const Velocity&  vo, const Velocity&  vi, const Velocity& nvo,
@@ -286,7 +286,7 @@ int CriteriaCore::losr_trk_iter_dir(const Vect2& s, const Vect2& vo, const Vect2
 }
 
 int CriteriaCore::trkSearchDirection(const Vect3& s, const Vect3& vo, const Vect3& vi, int eps) {
-  return losr_trk_iter_dir(s.vect2(),vo.vect2(),vi.vect2(),Units::from("deg",1), eps);
+  return losr_trk_iter_dir(s.vect2(),vo.vect2(),vi.vect2(),Units::from(units::deg,1), eps);
 }
 
 Vect2 CriteriaCore::incr_gs_vect(const Vect2& vo, double step, int dir) {
@@ -305,7 +305,7 @@ int CriteriaCore::losr_gs_iter_dir(const Vect2& s, const Vect2& vo, const Vect2&
 int CriteriaCore::gsSearchDirection(const Vect3& s, const Vect3& vo, const Vect3& vi, int eps) {
   double mings = 0; // Units::from("kn",150);
   double maxgs = DBL_MAX; // Units::from("kn",700);
-  return losr_gs_iter_dir(s.vect2(),vo.vect2(),vi.vect2(),mings, maxgs, Units::from("kn",1), eps);
+  return losr_gs_iter_dir(s.vect2(),vo.vect2(),vi.vect2(),mings, maxgs, Units::from(units::kn,1), eps);
 }
 
 int CriteriaCore::vsSearchDirection(int epsv) {
@@ -12,6 +12,8 @@
  */
 
 #include "CriticalVectors2D.h"
+#include "Util.h"
+#include <cmath>
 
 namespace larcfm {
   
@@ -80,4 +82,27 @@ namespace larcfm {
     return groundSpeeds(s,vo,vi,D,0,T);
   }
 
+  // Points u in the unit circle such that u*n = q, where n = r*(2*a*w+b) and q = -(a*(w*w+r^2)+b*w+c)
+  void CriticalVectors2D::circleTracks(std::vector<double>& trks, const Vect2& w, const double r,
+			  const double a, const Vect2& b, const double c) {
+    Vect2 n = w.Scal(2*a).Add(b).Scal(r);
+    double sqn = n.sqv();
+    if (Util::almost_equals(sqn,0)) {
+      return;
+    }
+    double q = -(a*(w.sqv()+sq(r))+b.dot(w)+c);
+    double h = 1-sq(q)/sqn;
+    if (h < 0) {
+      // Circles almost touch each other, the closest point is still critical
+      if (h > -1e-6) {
+	trks.push_back(n.Scal(Util::sign(q)).compassAngle());
+      }
+      return;
+    }
+    double k = q/sqn;
+    double m = std::sqrt(h/sqn);
+    trks.push_back(n.Scal(k).Add(n.PerpR().Scal(m)).compassAngle());
+    trks.push_back(n.Scal(k).Sub(n.PerpR().Scal(m)).compassAngle());
+  }
+
 }
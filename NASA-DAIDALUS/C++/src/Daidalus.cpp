@@ -90,18 +90,18 @@ namespace larcfm {
  * configured either programmatically, set_DO_365B() or
  * via a configuration file with the method loadFromFile(configurationfile)
  **/
-Daidalus::Daidalus() : error("Daidalus") {}
+Daidalus::Daidalus() : error("Daidalus"), parallel_bands_(false) {}
 
 /**
  * Construct a Daidalus object with initial alerter.
  */
-Daidalus::Daidalus(const Alerter& alerter) : error("Daidalus"), core_(alerter) {}
+Daidalus::Daidalus(const Alerter& alerter) : error("Daidalus"), core_(alerter), parallel_bands_(false) {}
 
 /**
  * Construct a Daidalus object with the default parameters and one alerter with the
  * given detector and T (in seconds) as the alerting time, early alerting time, and lookahead time.
  */
-Daidalus::Daidalus(const Detection3D* det, double T) : error("Daidalus"), core_(det,T) {}
+Daidalus::Daidalus(const Detection3D* det, double T) : error("Daidalus"), core_(det,T), parallel_bands_(false) {}
 
 /* Setting for WC Definitions RTCA DO-365 */
 
@@ -324,6 +324,78 @@ int Daidalus::addTrafficState(const std::string& id, const Position& pos, const
   return addTrafficState(id,pos,vel,core_.current_time);
 }
 
+/**
+ * Update ownship state and current time, keeping current traffic aircraft. Traffic states are
+ * linearly projected into the new current time and kept until they are updated with
+ * updateTrafficState or removed with removeStaleTraffic. Traffic aircraft whose position is not of
+ * the same kind as the new ownship's, i.e., lat/lon or Euclidean, are removed. If ownship has not
+ * been set, id is different from current ownship's identifier, or time is in the past, this method
+ * behaves as setOwnshipState, i.e., all traffic is cleared.
+ * @param id Ownship's identifier
+ * @param pos Ownship's position
+ * @param vel Ownship's ground velocity
+ * @param time Time stamp of ownship's state
+ */
+void Daidalus::updateOwnshipState(const std::string& id, const Position& pos, const Velocity& vel, double time) {
+  if (!hasOwnship() || !equals(core_.ownship.getId(),id) ||
+      time < getCurrentTime()) {
+    setOwnshipState(id,pos,vel,time);
+  } else {
+    if (time-getCurrentTime() > getHysteresisTime()) {
+      // Traffic is kept, but hysteresis is reset.
+      clearHysteresis();
+    }
+    core_.update_ownship_state(id,pos,vel,time);
+    stale_bands();
+  }
+}
+
+/**
+ * Update position and velocity of traffic aircraft at index ac_idx, keeping its identifier,
+ * alerter, and SUM data. If time is different from current time, traffic state is projected,
+ * past or future, into current time.
+ * @param ac_idx Aircraft's index, between 1 and lastTrafficIndex()
+ * @param pos Aircraft's position
+ * @param vel Aircraft's ground velocity
+ * @param time Time stamp of aircraft's state
+ * @return true if aircraft was updated
+ */
+bool Daidalus::updateTrafficState(int ac_idx, const Position& pos, const Velocity& vel, double time) {
+  if (core_.update_traffic_state(ac_idx-1,pos,vel,time)) {
+    stale_bands();
+    return true;
+  }
+  error.addError("updateTrafficState: aircraft index "+Fmi(ac_idx)+" is out of bounds or state is invalid");
+  return false;
+}
+
+/**
+ * Update position and velocity of traffic aircraft at index ac_idx at current time,
+ * keeping its identifier, alerter, and SUM data.
+ * @param ac_idx Aircraft's index, between 1 and lastTrafficIndex()
+ * @param pos Aircraft's position
+ * @param vel Aircraft's ground velocity
+ * @return true if aircraft was updated
+ */
+bool Daidalus::updateTrafficState(int ac_idx, const Position& pos, const Velocity& vel) {
+  return updateTrafficState(ac_idx,pos,vel,core_.current_time);
+}
+
+/**
+ * Remove traffic aircraft whose states have not been set or updated in the last max_age
+ * seconds, with respect to current time. Indices of remaining aircraft are compacted
+ * keeping their relative order.
+ * @param max_age Maximum age of traffic states [s]
+ * @return Number of removed aircraft
+ */
+int Daidalus::removeStaleTraffic(double max_age) {
+  int removed = core_.remove_stale_traffic(max_age);
+  if (removed > 0) {
+    stale_bands();
+  }
+  return removed;
+}
+
 
 /**
  * Get index of aircraft with given name. Return -1 if no such index exists
@@ -2671,6 +2743,18 @@ bool Daidalus::loadFromFile(const std::string& file) {
   return flag;
 }
 
+/**
+ *  Update current parameters with parameters from file, as loadFromFile. The file is parsed once
+ *  per process, unless it's modified. Alerters defined in the file, including their detector instances,
+ *  are shared with other Daidalus objects that load the same file and with copies of this object, until
+ *  they are modified.
+ */
+bool Daidalus::loadSharedFromFile(const std::string& file) {
+  bool flag = core_.parameters.loadSharedFromFile(file);
+  clearHysteresis();
+  return flag;
+}
+
 /**
  *  Write parameters to file.
  */
@@ -2751,8 +2835,58 @@ void Daidalus::reset() {
   stale_bands();
 }
 
+/**
+ * Enable/disable parallel computation of bands.
+ */
+void Daidalus::setParallelBands(bool flag) {
+  parallel_bands_ = flag;
+  hdir_band_.set_parallel(flag);
+  hs_band_.set_parallel(flag);
+  vs_band_.set_parallel(flag);
+  alt_band_.set_parallel(flag);
+}
+
+/**
+ * Return true if bands are computed in parallel.
+ */
+bool Daidalus::isParallelBands() const {
+  return parallel_bands_;
+}
+
 /* Main interface methods */
 
+/**
+ * Compute direction, horizontal speed, vertical speed, and altitude bands. The four dimensions
+ * are computed concurrently when parallel bands are enabled.
+ */
+void Daidalus::refreshBands() {
+  if (parallel_bands_ && DaidalusThreadPool::shared().getNumberOfThreads() > 0) {
+    // Once the core is refreshed, including alerting and DTA hysteresis at current time,
+    // bands in different dimensions only read it
+    core_.refresh();
+    std::vector<std::function<void()> > tasks;
+    tasks.push_back([this]() { hdir_band_.refresh(core_); });
+    tasks.push_back([this]() { hs_band_.refresh(core_); });
+    tasks.push_back([this]() { vs_band_.refresh(core_); });
+    tasks.push_back([this]() { alt_band_.refresh(core_); });
+    DaidalusThreadPool::shared().run(tasks);
+  } else {
+    hdir_band_.refresh(core_);
+    hs_band_.refresh(core_);
+    vs_band_.refresh(core_);
+    alt_band_.refresh(core_);
+  }
+}
+
+/**
+ * Return an immutable snapshot of alerting and bands at current time. All results are computed
+ * once by this method. The snapshot doesn't share state with this object, so it can be queried
+ * concurrently by several threads, even while this object is updated with new states.
+ */
+DaidalusResults Daidalus::snapshot() {
+  return DaidalusResults(*this);
+}
+
 /**
  * Compute in acs list of aircraft identifiers contributing to conflict bands for given
  * conflict bands region.
@@ -2829,6 +2963,17 @@ Interval Daidalus::horizontalDirectionIntervalAt(int i, const std::string& u) {
   return Interval(Units::to(u, ia.low), Units::to(u, ia.up));
 }
 
+/**
+ * Same as horizontalDirectionIntervalAt(i, u) with unit strings, but with typed units.
+ */
+Interval Daidalus::horizontalDirectionIntervalAt(int i, Unit u) {
+  Interval ia = hdir_band_.interval(core_,i);
+  if (ia.isEmpty()) {
+    return ia;
+  }
+  return Interval(Units::to(u, ia.low), Units::to(u, ia.up));
+}
+
 /**
  * @return the i-th region of the computed direction bands.
  * @param i index
@@ -2854,6 +2999,13 @@ int Daidalus::indexOfHorizontalDirection(double dir, const std::string& u) {
   return indexOfHorizontalDirection(Units::from(u, dir));
 }
 
+/**
+ * Same as indexOfHorizontalDirection(dir, u) with unit strings, but with typed units.
+ */
+int Daidalus::indexOfHorizontalDirection(double dir, Unit u) {
+  return indexOfHorizontalDirection(Units::from(u, dir));
+}
+
 /**
  * @return the region of a given direction specified in internal units [rad].
  * @param dir [rad]
@@ -2871,6 +3023,13 @@ BandsRegion::Region Daidalus::regionOfHorizontalDirection(double dir, const std:
   return horizontalDirectionRegionAt(indexOfHorizontalDirection(dir,u));
 }
 
+/**
+ * Same as regionOfHorizontalDirection(dir, u) with unit strings, but with typed units.
+ */
+BandsRegion::Region Daidalus::regionOfHorizontalDirection(double dir, Unit u) {
+  return horizontalDirectionRegionAt(indexOfHorizontalDirection(dir,u));
+}
+
 /**
  * Return last time to direction maneuver, in seconds, for ownship with respect to traffic
  * aircraft ac. Return NaN if the ownship is not in conflict with aircraft ac within
@@ -2914,6 +3073,18 @@ double Daidalus::lastTimeToHorizontalDirectionManeuver(int ac_idx, const std::st
   }
 }
 
+/**
+ * Same as lastTimeToHorizontalDirectionManeuver(ac_idx, u) with unit strings, but with typed units.
+ */
+double Daidalus::lastTimeToHorizontalDirectionManeuver(int ac_idx, Unit u)  {
+  double lt2m = lastTimeToHorizontalDirectionManeuver(ac_idx);
+  if (ISFINITE(lt2m)) {
+    return Units::to(u,lt2m);
+  } else {
+    return lt2m;
+  }
+}
+
 /**
  * @return recovery information for horizontal direction bands.
  */
@@ -2967,6 +3138,13 @@ double Daidalus::horizontalDirectionResolution(bool dir, const std::string& u) {
   return Units::to(u,horizontalDirectionResolution(dir));
 }
 
+/**
+ * Same as horizontalDirectionResolution(dir, u) with unit strings, but with typed units.
+ */
+double Daidalus::horizontalDirectionResolution(bool dir, Unit u) {
+  return Units::to(u,horizontalDirectionResolution(dir));
+}
+
 /**
  * Compute horizontal direction *raw* resolution maneuver for a given direction.
  * Raw resolution is the resolution without persistence
@@ -2994,6 +3172,13 @@ double Daidalus::horizontalDirectionRawResolution(bool dir, const std::string& u
   return Units::to(u,horizontalDirectionRawResolution(dir));
 }
 
+/**
+ * Same as horizontalDirectionRawResolution(dir, u) with unit strings, but with typed units.
+ */
+double Daidalus::horizontalDirectionRawResolution(bool dir, Unit u){
+  return Units::to(u,horizontalDirectionRawResolution(dir));
+}
+
 /**
  * Compute preferred horizontal direction based on resolution that is closer to current direction.
  * @return True: Right. False: Left.
@@ -3038,6 +3223,17 @@ Interval Daidalus::horizontalSpeedIntervalAt(int i, const std::string& u) {
   return Interval(Units::to(u, ia.low), Units::to(u, ia.up));
 }
 
+/**
+ * Same as horizontalSpeedIntervalAt(i, u) with unit strings, but with typed units.
+ */
+Interval Daidalus::horizontalSpeedIntervalAt(int i, Unit u) {
+  Interval ia = hs_band_.interval(core_,i);
+  if (ia.isEmpty()) {
+    return ia;
+  }
+  return Interval(Units::to(u, ia.low), Units::to(u, ia.up));
+}
+
 /**
  * @return the i-th region of the computed horizontal speed bands.
  * @param i index
@@ -3063,6 +3259,13 @@ int Daidalus::indexOfHorizontalSpeed(double gs, const std::string& u) {
   return indexOfHorizontalSpeed(Units::from(u,gs));
 }
 
+/**
+ * Same as indexOfHorizontalSpeed(gs, u) with unit strings, but with typed units.
+ */
+int Daidalus::indexOfHorizontalSpeed(double gs, Unit u) {
+  return indexOfHorizontalSpeed(Units::from(u,gs));
+}
+
 /**
  * @return the region of a given horizontal speed specified in internal units [m/s]
  * @param gs [m/s]
@@ -3080,6 +3283,13 @@ BandsRegion::Region Daidalus::regionOfHorizontalSpeed(double gs, const std::stri
   return horizontalSpeedRegionAt(indexOfHorizontalSpeed(gs,u));
 }
 
+/**
+ * Same as regionOfHorizontalSpeed(gs, u) with unit strings, but with typed units.
+ */
+BandsRegion::Region Daidalus::regionOfHorizontalSpeed(double gs, Unit u) {
+  return horizontalSpeedRegionAt(indexOfHorizontalSpeed(gs,u));
+}
+
 /**
  * Return last time to horizontal speed maneuver, in seconds, for ownship with respect to traffic
  * aircraft ac. Return NaN if the ownship is not in conflict with aircraft ac within
@@ -3123,6 +3333,18 @@ double Daidalus::lastTimeToHorizontalSpeedManeuver(int ac_idx, const std::string
   }
 }
 
+/**
+ * Same as lastTimeToHorizontalSpeedManeuver(ac_idx, u) with unit strings, but with typed units.
+ */
+double Daidalus::lastTimeToHorizontalSpeedManeuver(int ac_idx, Unit u) {
+  double lt2m = lastTimeToHorizontalSpeedManeuver(ac_idx);
+  if (ISFINITE(lt2m)) {
+    return Units::to(u,lt2m);
+  } else {
+    return lt2m;
+  }
+}
+
 
 /**
  * @return recovery information for horizontal speed bands.
@@ -3177,6 +3399,13 @@ double Daidalus::horizontalSpeedResolution(bool dir, const std::string& u) {
   return Units::to(u,horizontalSpeedResolution(dir));
 }
 
+/**
+ * Same as horizontalSpeedResolution(dir, u) with unit strings, but with typed units.
+ */
+double Daidalus::horizontalSpeedResolution(bool dir, Unit u) {
+  return Units::to(u,horizontalSpeedResolution(dir));
+}
+
 /**
  * Compute horizontal speed *raw* resolution maneuver.
  * Raw resolution is the resolution without persistence
@@ -3204,6 +3433,13 @@ double Daidalus::horizontalSpeedRawResolution(bool dir, const std::string& u) {
   return Units::to(u,horizontalSpeedRawResolution(dir));
 }
 
+/**
+ * Same as horizontalSpeedRawResolution(dir, u) with unit strings, but with typed units.
+ */
+double Daidalus::horizontalSpeedRawResolution(bool dir, Unit u) {
+  return Units::to(u,horizontalSpeedRawResolution(dir));
+}
+
 /**
  * Compute preferred horizontal speed direction on resolution that is closer to current horizontal speed.
  * True: Increase speed, False: Decrease speed.
@@ -3248,6 +3484,17 @@ Interval Daidalus::verticalSpeedIntervalAt(int i, const std::string& u) {
   return Interval(Units::to(u, ia.low), Units::to(u, ia.up));
 }
 
+/**
+ * Same as verticalSpeedIntervalAt(i, u) with unit strings, but with typed units.
+ */
+Interval Daidalus::verticalSpeedIntervalAt(int i, Unit u) {
+  Interval ia = vs_band_.interval(core_,i);
+  if (ia.isEmpty()) {
+    return ia;
+  }
+  return Interval(Units::to(u, ia.low), Units::to(u, ia.up));
+}
+
 /**
  * @return the i-th region of the computed vertical speed bands.
  * @param i index
@@ -3273,6 +3520,13 @@ int Daidalus::indexOfVerticalSpeed(double vs, const std::string& u) {
   return indexOfVerticalSpeed(Units::from(u, vs));
 }
 
+/**
+ * Same as indexOfVerticalSpeed(vs, u) with unit strings, but with typed units.
+ */
+int Daidalus::indexOfVerticalSpeed(double vs, Unit u) {
+  return indexOfVerticalSpeed(Units::from(u, vs));
+}
+
 /**
  * @return the region of a given vertical speed specified in internal units [m/s]
  * @param vs [m/s]
@@ -3290,6 +3544,13 @@ BandsRegion::Region Daidalus::regionOfVerticalSpeed(double vs, const std::string
   return verticalSpeedRegionAt(indexOfVerticalSpeed(vs,u));
 }
 
+/**
+ * Same as regionOfVerticalSpeed(vs, u) with unit strings, but with typed units.
+ */
+BandsRegion::Region Daidalus::regionOfVerticalSpeed(double vs, Unit u) {
+  return verticalSpeedRegionAt(indexOfVerticalSpeed(vs,u));
+}
+
 /**
  * Return last time to vertical speed maneuver, in seconds, for ownship with respect to traffic
  * aircraft ac. Return NaN if the ownship is not in conflict with aircraft ac within
@@ -3333,6 +3594,18 @@ double Daidalus::lastTimeToVerticalSpeedManeuver(int ac_idx, const std::string&
   }
 }
 
+/**
+ * Same as lastTimeToVerticalSpeedManeuver(ac_idx, u) with unit strings, but with typed units.
+ */
+double Daidalus::lastTimeToVerticalSpeedManeuver(int ac_idx, Unit u)  {
+  double lt2m = lastTimeToVerticalSpeedManeuver(ac_idx);
+  if (ISFINITE(lt2m)) {
+    return Units::to(u,lt2m);
+  } else {
+    return lt2m;
+  }
+}
+
 /**
  * @return recovery information for vertical speed bands.
  */
@@ -3386,6 +3659,13 @@ double Daidalus::verticalSpeedResolution(bool dir, const std::string& u) {
   return Units::to(u,verticalSpeedResolution(dir));
 }
 
+/**
+ * Same as verticalSpeedResolution(dir, u) with unit strings, but with typed units.
+ */
+double Daidalus::verticalSpeedResolution(bool dir, Unit u) {
+  return Units::to(u,verticalSpeedResolution(dir));
+}
+
 /**
  * Compute vertical speed *raw* resolution maneuver for given direction.
  * Raw resolution is the resolution without persistence
@@ -3413,6 +3693,13 @@ double Daidalus::verticalSpeedRawResolution(bool dir, const std::string& u) {
   return Units::to(u,verticalSpeedRawResolution(dir));
 }
 
+/**
+ * Same as verticalSpeedRawResolution(dir, u) with unit strings, but with typed units.
+ */
+double Daidalus::verticalSpeedRawResolution(bool dir, Unit u) {
+  return Units::to(u,verticalSpeedRawResolution(dir));
+}
+
 /**
  * Compute preferred  vertical speed direction based on resolution that is closer to current vertical speed.
  * True: Increase speed, False: Decrease speed.
@@ -3457,6 +3744,17 @@ Interval Daidalus::altitudeIntervalAt(int i, const std::string& u) {
   return Interval(Units::to(u, ia.low), Units::to(u, ia.up));
 }
 
+/**
+ * Same as altitudeIntervalAt(i, u) with unit strings, but with typed units.
+ */
+Interval Daidalus::altitudeIntervalAt(int i, Unit u) {
+  Interval ia = alt_band_.interval(core_,i);
+  if (ia.isEmpty()) {
+    return ia;
+  }
+  return Interval(Units::to(u, ia.low), Units::to(u, ia.up));
+}
+
 /**
  * @return the i-th region of the computed altitude bands.
  * @param i index
@@ -3482,6 +3780,13 @@ int Daidalus::indexOfAltitude(double alt, const std::string& u) {
   return indexOfAltitude(Units::from(u,alt));
 }
 
+/**
+ * Same as indexOfAltitude(alt, u) with unit strings, but with typed units.
+ */
+int Daidalus::indexOfAltitude(double alt, Unit u) {
+  return indexOfAltitude(Units::from(u,alt));
+}
+
 /**
  * @return the region of a given altitude specified in internal units [m]
  * @param alt [m]
@@ -3499,6 +3804,13 @@ BandsRegion::Region Daidalus::regionOfAltitude(double alt, const std::string& u)
   return altitudeRegionAt(indexOfAltitude(alt,u));
 }
 
+/**
+ * Same as regionOfAltitude(alt, u) with unit strings, but with typed units.
+ */
+BandsRegion::Region Daidalus::regionOfAltitude(double alt, Unit u) {
+  return altitudeRegionAt(indexOfAltitude(alt,u));
+}
+
 /**
  * Return last time to altitude maneuver, in seconds, for ownship with respect to traffic
  * aircraft ac. Return NaN if the ownship is not in conflict with aircraft ac within
@@ -3542,6 +3854,18 @@ double Daidalus::lastTimeToAltitudeManeuver(int ac_idx, const std::string& u)  {
   }
 }
 
+/**
+ * Same as lastTimeToAltitudeManeuver(ac_idx, u) with unit strings, but with typed units.
+ */
+double Daidalus::lastTimeToAltitudeManeuver(int ac_idx, Unit u)  {
+  double lt2m = lastTimeToAltitudeManeuver(ac_idx);
+  if (ISFINITE(lt2m)) {
+    return Units::to(u,lt2m);
+  } else {
+    return lt2m;
+  }
+}
+
 /**
  * @return recovery information for altitude speed bands.
  */
@@ -3595,6 +3919,13 @@ double Daidalus::altitudeResolution(bool dir, const std::string& u) {
   return Units::to(u,altitudeResolution(dir));
 }
 
+/**
+ * Same as altitudeResolution(dir, u) with unit strings, but with typed units.
+ */
+double Daidalus::altitudeResolution(bool dir, Unit u) {
+  return Units::to(u,altitudeResolution(dir));
+}
+
 /**
  * Compute altitude *raw* resolution maneuver for given direction.
  * Raw resolution is the resolution without persistence
@@ -3622,6 +3953,13 @@ double Daidalus::altitudeRawResolution(bool dir, const std::string& u) {
   return Units::to(u,altitudeRawResolution(dir));
 }
 
+/**
+ * Same as altitudeRawResolution(dir, u) with unit strings, but with typed units.
+ */
+double Daidalus::altitudeRawResolution(bool dir, Unit u) {
+  return Units::to(u,altitudeRawResolution(dir));
+}
+
 /**
  * Compute preferred  altitude direction on resolution that is closer to current altitude.
  * True: Climb, False: Descend.
@@ -3692,8 +4030,7 @@ int Daidalus::alertLevelAllTraffic() {
  */
 ConflictData Daidalus::violationOfAlertThresholds(int ac_idx, int alert_level) {
   if (1 <= ac_idx && ac_idx <= lastTrafficIndex()) {
-    const TrafficState& intruder = core_.traffic[ac_idx-1];
-    int alerter_idx = core_.alerter_index_of(intruder);
+    int alerter_idx = core_.traffic_alerter_index(ac_idx-1);
     if (1 <= alerter_idx && alerter_idx <= core_.parameters.numberOfAlerters()) {
       const Alerter& alerter = core_.parameters.getAlerterAt(alerter_idx);
       if (alert_level == 0) {
@@ -3702,7 +4039,7 @@ ConflictData Daidalus::violationOfAlertThresholds(int ac_idx, int alert_level) {
       if (alert_level > 0) {
         Detection3D* detector = alerter.getDetectorPtr(alert_level);
         if (detector != NULL) {
-          return detector->conflictDetectionWithTrafficState(core_.ownship,intruder,0.0,core_.parameters.getLookaheadTime());
+          return core_.conflict_detection(detector,ac_idx-1,0.0,core_.parameters.getLookaheadTime());
         } else {
           error.addError("violationOfAlertThresholds: detector of traffic aircraft "+Fmi(ac_idx)+" is not set");
         }
@@ -3766,8 +4103,7 @@ double Daidalus::timeToCorrectiveVolume(int ac_idx) {
  */
 BandsRegion::Region Daidalus::regionOfAlertLevel(int ac_idx, int alert_level) {
   if (1 <= ac_idx && ac_idx <= lastTrafficIndex()) {
-    const TrafficState& intruder = core_.traffic[ac_idx-1];
-    int alerter_idx = core_.alerter_index_of(intruder);
+    int alerter_idx = core_.traffic_alerter_index(ac_idx-1);
     if (1 <= alerter_idx && alerter_idx <= core_.parameters.numberOfAlerters()) {
       if (alert_level == 0) {
           return BandsRegion::NONE;
@@ -3806,8 +4142,7 @@ int Daidalus::alertLevelOfRegion(int ac_idx, int region) {
  */
 int Daidalus::alertLevelOfRegion(int ac_idx, BandsRegion::Region region) {
   if (1 <= ac_idx && ac_idx <= lastTrafficIndex()) {
-    const TrafficState& intruder = core_.traffic[ac_idx-1];
-    int alerter_idx = core_.alerter_index_of(intruder);
+    int alerter_idx = core_.traffic_alerter_index(ac_idx-1);
     if (1 <= alerter_idx && alerter_idx <= core_.parameters.numberOfAlerters()) {
       const Alerter& alerter = core_.parameters.getAlerterAt(alerter_idx);
       return alerter.alertLevelForRegion(region);
@@ -3847,6 +4182,17 @@ double Daidalus::currentHorizontalSeparation(int ac_idx,const std::string& u) co
   }
 }
 
+/**
+ * Same as currentHorizontalSeparation(ac_idx, u) with unit strings, but with typed units.
+ */
+double Daidalus::currentHorizontalSeparation(int ac_idx,Unit u) const {
+  if (1 <= ac_idx && ac_idx <= lastTrafficIndex()) {
+    return Units::to(u,currentHorizontalSeparation(ac_idx));
+  } else {
+    return NaN;
+  }
+}
+
 /**
  * Returns current vertical separation, in internal units, with aircraft at index ac_idx.
  * Returns NaN if aircraft index is not valid
@@ -3872,6 +4218,17 @@ double Daidalus::currentVerticalSeparation(int ac_idx,const std::string& u) cons
   }
 }
 
+/**
+ * Same as currentVerticalSeparation(ac_idx, u) with unit strings, but with typed units.
+ */
+double Daidalus::currentVerticalSeparation(int ac_idx,Unit u) const {
+  if (1 <= ac_idx && ac_idx <= lastTrafficIndex()) {
+    return Units::to(u,currentVerticalSeparation(ac_idx));
+  } else {
+    return NaN;
+  }
+}
+
 /**
  * Returns horizontal closure rate, in internal units, with aircraft at index ac_idx.
  * Returns NaN if aircraft index is not valid
@@ -3897,6 +4254,17 @@ double Daidalus::horizontalClosureRate(int ac_idx,const std::string& u) const {
   }
 }
 
+/**
+ * Same as horizontalClosureRate(ac_idx, u) with unit strings, but with typed units.
+ */
+double Daidalus::horizontalClosureRate(int ac_idx,Unit u) const {
+  if (1 <= ac_idx && ac_idx <= lastTrafficIndex()) {
+    return Units::to(u,horizontalClosureRate(ac_idx));
+  } else {
+    return NaN;
+  }
+}
+
 /**
  * Returns vertical closure rate, in internal units, with aircraft at index ac_idx.
  * Returns NaN if aircraft index is not valid
@@ -3922,6 +4290,17 @@ double Daidalus::verticalClosureRate(int ac_idx,const std::string& u) const {
   }
 }
 
+/**
+ * Same as verticalClosureRate(ac_idx, u) with unit strings, but with typed units.
+ */
+double Daidalus::verticalClosureRate(int ac_idx,Unit u) const {
+  if (1 <= ac_idx && ac_idx <= lastTrafficIndex()) {
+    return Units::to(u,verticalClosureRate(ac_idx));
+  } else {
+    return NaN;
+  }
+}
+
 /**
  * Returns predicted HMD, in internal units, with aircraft at index ac_idx (up to lookahead time),
  * assuming straight line trajectory. Returns NaN if aircraft index is not valid
@@ -3947,6 +4326,17 @@ double Daidalus::predictedHorizontalMissDistance(int ac_idx, const std::string&
   }
 }
 
+/**
+ * Same as predictedHorizontalMissDistance(ac_idx, u) with unit strings, but with typed units.
+ */
+double Daidalus::predictedHorizontalMissDistance(int ac_idx, Unit u) const {
+  if (1 <= ac_idx && ac_idx <= lastTrafficIndex()) {
+    return Units::to(u,predictedHorizontalMissDistance(ac_idx));
+  } else {
+    return NaN;
+  }
+}
+
 /**
  * Returns predicted VMD, in internal units, with aircraft at index ac_idx (up to lookahead time),
  * assuming straight line trajectory. Returns NaN if aircraft index is not valid
@@ -3973,6 +4363,17 @@ double Daidalus::predictedVerticalMissDistance(int ac_idx, const std::string& u)
   }
 }
 
+/**
+ * Same as predictedVerticalMissDistance(ac_idx, u) with unit strings, but with typed units.
+ */
+double Daidalus::predictedVerticalMissDistance(int ac_idx, Unit u) const {
+  if (1 <= ac_idx && ac_idx <= lastTrafficIndex()) {
+    return Units::to(u,predictedVerticalMissDistance(ac_idx));
+  } else {
+    return NaN;
+  }
+}
+
 /**
  * Returns time, in seconds, to horizontal closest point of approach with aircraft
  * at index ac_idx, assuming straight line trajectory.
@@ -4004,6 +4405,17 @@ double Daidalus::timeToHorizontalClosestPointOfApproach(int ac_idx, const std::s
   }
 }
 
+/**
+ * Same as timeToHorizontalClosestPointOfApproach(ac_idx, u) with unit strings, but with typed units.
+ */
+double Daidalus::timeToHorizontalClosestPointOfApproach(int ac_idx, Unit u) const {
+  if (1 <= ac_idx && ac_idx <= lastTrafficIndex()) {
+    return Units::to(u,timeToHorizontalClosestPointOfApproach(ac_idx));
+  } else {
+    return NaN;
+  }
+}
+
 /**
  * Returns distance, in internal units, at horizontal closest point of approach with aircraft
  * at index ac_idx, assuming straight line trajectory.
@@ -4039,6 +4451,17 @@ double Daidalus::distanceAtHorizontalClosestPointOfApproach(int ac_idx, const st
   }
 }
 
+/**
+ * Same as distanceAtHorizontalClosestPointOfApproach(ac_idx, u) with unit strings, but with typed units.
+ */
+double Daidalus::distanceAtHorizontalClosestPointOfApproach(int ac_idx, Unit u) const {
+  if (1 <= ac_idx && ac_idx <= lastTrafficIndex()) {
+    return Units::to(u,distanceAtHorizontalClosestPointOfApproach(ac_idx));
+  } else {
+    return NaN;
+  }
+}
+
 /**
  * Returns time, in seconds, to co-altitude with aircraft
  * at index ac_idx, assuming straight line trajectory.
@@ -4074,6 +4497,17 @@ double Daidalus::timeToCoAltitude(int ac_idx, const std::string& u) const {
   }
 }
 
+/**
+ * Same as timeToCoAltitude(ac_idx, u) with unit strings, but with typed units.
+ */
+double Daidalus::timeToCoAltitude(int ac_idx, Unit u) const {
+  if (1 <= ac_idx && ac_idx <= lastTrafficIndex()) {
+    return Units::to(u,timeToCoAltitude(ac_idx));
+  } else {
+    return NaN;
+  }
+}
+
 /**
  * Returns modified tau time, in seconds, for distance DMOD (given in internal units),
  * with respect to aircraft at index ac_idx.
@@ -4109,6 +4543,142 @@ double Daidalus::modifiedTau(int ac_idx, double DMOD, const std::string& DMODu,
   }
 }
 
+/**
+ * Same as modifiedTau(ac_idx, DMOD, DMODu, u) with unit strings, but with typed units.
+ */
+double Daidalus::modifiedTau(int ac_idx, double DMOD, Unit DMODu, Unit u) const {
+  if (1 <= ac_idx && ac_idx <= lastTrafficIndex()) {
+    return Units::to(u,modifiedTau(ac_idx,Units::from(DMODu,DMOD)));
+  } else {
+    return NaN;
+  }
+}
+
+
+/* What-if queries */
+
+/**
+ * Returns a hypothetical ownship state with the position of the current ownship and
+ * ground velocity vel. This state can be used in what-if queries. A what-if query
+ * evaluates a hypothetical ownship state against the current traffic aircraft without
+ * modifying aircraft states, cached values, or hysteresis information.
+ */
+TrafficState Daidalus::hypotheticalOwnshipState(const Velocity& vel) const {
+  if (hasOwnship()) {
+    return core_.ownship_with_velocity(vel);
+  } else {
+    error.addError("hypotheticalOwnshipState: ownship has not been set");
+    return TrafficState::INVALID();
+  }
+}
+
+/**
+ * What-if query. Detects violation of alert thresholds for a given alert level between the
+ * hypothetical ownship state own and aircraft at index ac_idx.
+ * @param own is a hypothetical ownship state, e.g., computed with hypotheticalOwnshipState
+ * @param ac_idx is the index of the traffic aircraft
+ * @param alert_level alert level used to compute detection. The value 0
+ * indicate the alert volume of the corrective region.
+ */
+ConflictData Daidalus::violationOfAlertThresholds(const TrafficState& own, int ac_idx, int alert_level) const {
+  if (1 <= ac_idx && ac_idx <= lastTrafficIndex()) {
+    ConflictData det;
+    int code = core_.violation_of_alert_thresholds(det,own,ac_idx-1,alert_level);
+    switch (code) {
+    case 1: error.addError("violationOfAlertThresholds: detector of traffic aircraft "+Fmi(ac_idx)+" is not set");
+    break;
+    case 2: error.addError("violationOfAlertThresholds: no corrective alerter level for alerter of "+Fmi(ac_idx));
+    break;
+    case 3: error.addError("violationOfAlertThresholds: alerter of traffic aircraft "+Fmi(ac_idx)+" is out of bounds");
+    break;
+    default:
+      return det;
+    }
+  } else {
+    error.addError("violationOfAlertThresholds: aircraft index "+Fmi(ac_idx)+" is out of bounds");
+  }
+  return ConflictData::EMPTY();
+}
+
+/**
+ * What-if query. Detects violation of corrective thresholds between the hypothetical
+ * ownship state own and aircraft at index ac_idx.
+ * @param own is a hypothetical ownship state, e.g., computed with hypotheticalOwnshipState
+ * @param ac_idx is the index of the traffic aircraft
+ */
+ConflictData Daidalus::violationOfCorrectiveThresholds(const TrafficState& own, int ac_idx) const {
+  return violationOfAlertThresholds(own,ac_idx,0);
+}
+
+/**
+ * What-if query. Returns time to corrective volume, in seconds, between the hypothetical ownship
+ * state own and aircraft at index ac_idx. POSITIVE_INFINITY means no conflict within lookahead time.
+ * NaN means aircraft index is out of range.
+ */
+double Daidalus::timeToCorrectiveVolume(const TrafficState& own, int ac_idx) const {
+  if (1 <= ac_idx && ac_idx <= lastTrafficIndex()) {
+    ConflictData det = violationOfCorrectiveThresholds(own,ac_idx);
+    if (det.conflict()) {
+      return det.getTimeIn();
+    }
+    return PINFINITY;
+  } else {
+    error.addError("timeToCorrectiveVolume: aircraft index "+Fmi(ac_idx)+" is out of bounds");
+    return NaN;
+  }
+}
+
+/**
+ * What-if query. Returns time, in seconds, to horizontal closest point of approach between
+ * the hypothetical ownship state own and aircraft at index ac_idx, assuming straight line trajectory.
+ * If aircraft are diverging, the returned time is 0.
+ * Returns NaN if aircraft index is not valid
+ */
+double Daidalus::timeToHorizontalClosestPointOfApproach(const TrafficState& own, int ac_idx) const {
+  if (1 <= ac_idx && ac_idx <= lastTrafficIndex()) {
+    Vect3 s = own.get_s()-core_.traffic[ac_idx-1].get_s();
+    Vect3 v = own.get_v()-core_.traffic[ac_idx-1].get_v();
+    return Util::max(0.0,Horizontal::tcpa(s.vect2(),v.vect2()));
+  } else {
+    return NaN;
+  }
+}
+
+/**
+ * Batched what-if query for a list of horizontal directions, in internal units [rad].
+ * For the k-th direction, a hypothetical ownship flying that direction, with the horizontal
+ * and vertical speeds of the ground velocity vel, is evaluated against all traffic aircraft.
+ * On return, tin[k] is the earliest time to corrective volume, in seconds, and tcpa[k] is the minimum
+ * time to horizontal closest point of approach, in seconds, among the aircraft in conflict.
+ * Both values are POSITIVE_INFINITY when the k-th direction is conflict free within lookahead time.
+ */
+void Daidalus::horizontalDirectionConflicts(std::vector<double>& tin, std::vector<double>& tcpa,
+    const Velocity& vel, const std::vector<double>& dirs) const {
+  if (!hasOwnship()) {
+    error.addError("horizontalDirectionConflicts: ownship has not been set");
+  }
+  std::vector<Velocity> vels;
+  vels.reserve(dirs.size());
+  for (std::vector<double>::const_iterator dir_ptr = dirs.begin(); dir_ptr != dirs.end(); ++dir_ptr) {
+    vels.push_back(vel.mkTrk(*dir_ptr));
+  }
+  core_.corrective_conflicts(tin,tcpa,vels);
+}
+
+/**
+ * Batched what-if query for a list of horizontal directions, in given units [u].
+ * Same as above, but the current ownship's ground velocity provides the horizontal and
+ * vertical speeds of the hypothetical ownship.
+ */
+void Daidalus::horizontalDirectionConflicts(std::vector<double>& tin, std::vector<double>& tcpa,
+    const std::vector<double>& dirs, const std::string& u) const {
+  std::vector<double> dirs_rad;
+  dirs_rad.reserve(dirs.size());
+  for (std::vector<double>::const_iterator dir_ptr = dirs.begin(); dir_ptr != dirs.end(); ++dir_ptr) {
+    dirs_rad.push_back(Units::from(u,*dir_ptr));
+  }
+  horizontalDirectionConflicts(tin,tcpa,core_.ownship.getGroundVelocity(),dirs_rad);
+}
 
 /* Input/Output methods */
 
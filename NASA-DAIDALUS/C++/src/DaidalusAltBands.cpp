@@ -57,6 +57,11 @@ bool DaidalusAltBands::instantaneous_bands(const DaidalusParameters& parameters)
       parameters.getVerticalAcceleration() == 0;
 }
 
+// Altitude trajectories depend on the target altitude
+bool DaidalusAltBands::shared_trajectory(const DaidalusParameters& parameters) const {
+  return false;
+}
+
 double DaidalusAltBands::own_val(const TrafficState& ownship) const {
   return ownship.positionXYZ().alt();
 }
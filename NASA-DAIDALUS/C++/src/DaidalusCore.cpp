@@ -20,6 +20,7 @@
 #include <vector>
 #include <string>
 #include <cmath>
+#include <algorithm>
 #include "TrafficState.h"
 
 namespace larcfm {
@@ -32,7 +33,9 @@ DaidalusCore::DaidalusCore()
 , parameters()
 , urgency_strategy_(new NoneUrgencyStrategy())
 , cache_(0) // Cached_ variables are cleared
-, acs_conflict_bands_(std::vector<std::vector<IndexLevelT> >(BandsRegion::NUMBER_OF_CONFLICT_BANDS)) {
+, acs_conflict_bands_(std::vector<std::vector<IndexLevelT> >(BandsRegion::NUMBER_OF_CONFLICT_BANDS))
+, ownship_slot_(-1) {
+  ownship_slot_ = intern_slot(ownship.getId());
   stale();
 }
 
@@ -44,7 +47,9 @@ DaidalusCore::DaidalusCore(const Alerter& alerter)
 , parameters()
 , urgency_strategy_(new NoneUrgencyStrategy())
 , cache_(0) // Cached_ variables are cleared
-, acs_conflict_bands_(std::vector<std::vector<IndexLevelT> >(BandsRegion::NUMBER_OF_CONFLICT_BANDS)) {
+, acs_conflict_bands_(std::vector<std::vector<IndexLevelT> >(BandsRegion::NUMBER_OF_CONFLICT_BANDS))
+, ownship_slot_(-1) {
+  ownship_slot_ = intern_slot(ownship.getId());
   parameters.addAlerter(alerter);
   stale();
 }
@@ -57,7 +62,9 @@ DaidalusCore::DaidalusCore(const Detection3D* det, double T)
 , parameters()
 , urgency_strategy_(new NoneUrgencyStrategy())
 , cache_(0) // Cached_ variables are cleared
-, acs_conflict_bands_(std::vector<std::vector<IndexLevelT> >(BandsRegion::NUMBER_OF_CONFLICT_BANDS)) {
+, acs_conflict_bands_(std::vector<std::vector<IndexLevelT> >(BandsRegion::NUMBER_OF_CONFLICT_BANDS))
+, ownship_slot_(-1) {
+  ownship_slot_ = intern_slot(ownship.getId());
   parameters.addAlerter(Alerter::SingleBands(det,T,T));
   parameters.setLookaheadTime(T);
   stale();
@@ -70,8 +77,19 @@ DaidalusCore::DaidalusCore(const DaidalusCore& core)
 , wind_vector(core.wind_vector)
 , parameters(core.parameters)
 , urgency_strategy_(core.urgency_strategy_)
+, traffic_update_time_(core.traffic_update_time_)
 , cache_(0) // Cached_ variables are cleared
-, acs_conflict_bands_(std::vector<std::vector<IndexLevelT> >(BandsRegion::NUMBER_OF_CONFLICT_BANDS)) {
+, acs_conflict_bands_(std::vector<std::vector<IndexLevelT> >(BandsRegion::NUMBER_OF_CONFLICT_BANDS))
+, slots_(core.slots_)
+, slot_ids_(core.slot_ids_)
+, slot_traffic_idx_(core.slot_traffic_idx_)
+, traffic_slots_(core.traffic_slots_)
+, ownship_slot_(core.ownship_slot_)
+// Hysteresis variables are cleared
+, alerting_hysteresis_acs_(core.slot_ids_.size())
+, alerting_hysteresis_set_(core.slot_ids_.size(),false)
+, dta_hysteresis_acs_(core.slot_ids_.size())
+, dta_hysteresis_set_(core.slot_ids_.size(),false) {
   stale();
 }
 
@@ -84,6 +102,31 @@ void DaidalusCore::copyFrom(const DaidalusCore& core) {
     parameters = core.parameters;
     delete urgency_strategy_;
     urgency_strategy_ = core.urgency_strategy_->copy();
+    traffic_update_time_ = core.traffic_update_time_;
+    // Hysteresis variables are kept per aircraft identifier
+    std::vector<std::string> ids = slot_ids_;
+    std::vector<HysteresisData> alerting_hysteresis = alerting_hysteresis_acs_;
+    std::vector<bool> alerting_set = alerting_hysteresis_set_;
+    std::vector<HysteresisData> dta_hysteresis = dta_hysteresis_acs_;
+    std::vector<bool> dta_set = dta_hysteresis_set_;
+    slots_ = core.slots_;
+    slot_ids_ = core.slot_ids_;
+    slot_traffic_idx_ = core.slot_traffic_idx_;
+    traffic_slots_ = core.traffic_slots_;
+    ownship_slot_ = core.ownship_slot_;
+    alerting_hysteresis_acs_.assign(slot_ids_.size(),HysteresisData());
+    alerting_hysteresis_set_.assign(slot_ids_.size(),false);
+    dta_hysteresis_acs_.assign(slot_ids_.size(),HysteresisData());
+    dta_hysteresis_set_.assign(slot_ids_.size(),false);
+    for (int i = 0; i < static_cast<int>(ids.size()); ++i) {
+      if (alerting_set[i] || dta_set[i]) {
+        int slot = intern_slot(ids[i]);
+        alerting_hysteresis_acs_[slot] = alerting_hysteresis[i];
+        alerting_hysteresis_set_[slot] = alerting_set[i];
+        dta_hysteresis_acs_[slot] = dta_hysteresis[i];
+        dta_hysteresis_set_[slot] = dta_set[i];
+      }
+    }
     // Cached_ variables are cleared
     cache_ = 0;
     stale();
@@ -116,6 +159,10 @@ bool DaidalusCore::set_urgency_strategy(const UrgencyStrategy* strat) {
 void DaidalusCore::clear() {
   ownship = TrafficState::INVALID();
   traffic.clear();
+  traffic_update_time_.clear();
+  traffic_slots_.clear();
+  slot_traffic_idx_.assign(slot_ids_.size(),-1);
+  ownship_slot_ = intern_slot(ownship.getId());
   current_time = 0;
   clear_hysteresis();
 }
@@ -150,16 +197,94 @@ bool DaidalusCore::set_alerter_traffic(int idx, int alerter_idx) {
  *  Clear alerting hysteresis information from this object.
  */
 void DaidalusCore::clear_hysteresis() {
-  alerting_hysteresis_acs_.clear();
-  dta_hysteresis_acs_.clear();
+  alerting_hysteresis_set_.assign(slot_ids_.size(),false);
+  dta_hysteresis_set_.assign(slot_ids_.size(),false);
+  compact_slots();
   stale();
 }
 
+// Return slot of aircraft id. A new slot is created if id hasn't been seen before
+int DaidalusCore::intern_slot(const std::string& id) {
+  std::map<std::string,int>::const_iterator slot_ptr = slots_.find(id);
+  if (slot_ptr != slots_.end()) {
+    return slot_ptr->second;
+  }
+  int slot = slot_ids_.size();
+  slots_[id] = slot;
+  slot_ids_.push_back(id);
+  slot_traffic_idx_.push_back(-1);
+  alerting_hysteresis_acs_.push_back(HysteresisData());
+  alerting_hysteresis_set_.push_back(false);
+  dta_hysteresis_acs_.push_back(HysteresisData());
+  dta_hysteresis_set_.push_back(false);
+  return slot;
+}
+
+// Return slot of aircraft id (-1 if id hasn't been seen before)
+int DaidalusCore::find_slot(const std::string& id) const {
+  std::map<std::string,int>::const_iterator slot_ptr = slots_.find(id);
+  if (slot_ptr != slots_.end()) {
+    return slot_ptr->second;
+  }
+  return -1;
+}
+
+// Clear hysteresis of given slot
+void DaidalusCore::clear_slot_hysteresis(int slot) {
+  alerting_hysteresis_set_[slot] = false;
+  dta_hysteresis_set_[slot] = false;
+}
+
+// Remove slots of aircraft that are neither in the traffic list nor have hysteresis values
+void DaidalusCore::compact_slots() {
+  int kept = 0;
+  slots_.clear();
+  for (int slot = 0; slot < static_cast<int>(slot_ids_.size()); ++slot) {
+    if (slot == ownship_slot_ || slot_traffic_idx_[slot] >= 0 ||
+        alerting_hysteresis_set_[slot] || dta_hysteresis_set_[slot]) {
+      if (kept != slot) {
+        slot_ids_[kept] = slot_ids_[slot];
+        slot_traffic_idx_[kept] = slot_traffic_idx_[slot];
+        alerting_hysteresis_acs_[kept] = alerting_hysteresis_acs_[slot];
+        alerting_hysteresis_set_[kept] = alerting_hysteresis_set_[slot];
+        dta_hysteresis_acs_[kept] = dta_hysteresis_acs_[slot];
+        dta_hysteresis_set_[kept] = dta_hysteresis_set_[slot];
+        if (slot == ownship_slot_) {
+          ownship_slot_ = kept;
+        }
+        if (slot_traffic_idx_[kept] >= 0) {
+          traffic_slots_[slot_traffic_idx_[kept]] = kept;
+        }
+      }
+      slots_[slot_ids_[kept]] = kept;
+      ++kept;
+    }
+  }
+  slot_ids_.resize(kept);
+  slot_traffic_idx_.resize(kept);
+  alerting_hysteresis_acs_.resize(kept);
+  alerting_hysteresis_set_.resize(kept);
+  dta_hysteresis_acs_.resize(kept);
+  dta_hysteresis_set_.resize(kept);
+}
+
+// Recompute slot_traffic_idx_ from traffic_slots_
+void DaidalusCore::reindex_traffic_slots() {
+  slot_traffic_idx_.assign(slot_ids_.size(),-1);
+  for (int i = 0; i < static_cast<int>(traffic_slots_.size()); ++i) {
+    slot_traffic_idx_[traffic_slots_[i]] = i;
+  }
+}
+
 /**
  * Set cached values to stale conditions as they are no longer fresh.
  * If hysteresis is true, it also clears hysteresis variables
  */
 void DaidalusCore::stale() {
+  // Cached detections may have been computed while values were already stale
+  detections_.clear();
+  // Traffic list may have changed even if values were already stale
+  traffic_arrays_fresh_ = false;
   if (cache_ >= 0) {
     cache_ = -1;
     most_urgent_ac_ = TrafficState::INVALID();
@@ -171,12 +296,13 @@ void DaidalusCore::stale() {
       tiov_[conflict_region] = Interval::EMPTY;
       bands4region_[conflict_region] = false;
     }
-    std::map<std::string,HysteresisData>::iterator hysteresis_ptr;
-    for (hysteresis_ptr = alerting_hysteresis_acs_.begin();hysteresis_ptr != alerting_hysteresis_acs_.end();++hysteresis_ptr) {
-      hysteresis_ptr->second.outdateIfCurrentTime(current_time);
-    }
-    for (hysteresis_ptr = dta_hysteresis_acs_.begin();hysteresis_ptr != dta_hysteresis_acs_.end();++hysteresis_ptr) {
-      hysteresis_ptr->second.outdateIfCurrentTime(current_time);
+    for (int slot = 0; slot < static_cast<int>(slot_ids_.size()); ++slot) {
+      if (alerting_hysteresis_set_[slot]) {
+        alerting_hysteresis_acs_[slot].outdateIfCurrentTime(current_time);
+      }
+      if (dta_hysteresis_set_[slot]) {
+        dta_hysteresis_acs_[slot].outdateIfCurrentTime(current_time);
+      }
     }
   }
 }
@@ -188,6 +314,53 @@ bool DaidalusCore::isFresh() const {
   return cache_ > 0;
 }
 
+int DaidalusCore::TrafficArrays::size() const {
+  return sx.size();
+}
+
+void DaidalusCore::TrafficArrays::clear() {
+  sx.clear(); sy.clear(); sz.clear();
+  vx.clear(); vy.clear(); vz.clear();
+  s_EW_std.clear(); s_NS_std.clear(); s_EN_std.clear(); sz_std.clear();
+  v_EW_std.clear(); v_NS_std.clear(); v_EN_std.clear(); vz_std.clear();
+  slot.clear();
+}
+
+void DaidalusCore::TrafficArrays::push_back(const TrafficState& ac, int ac_slot) {
+  const Vect3& s = ac.get_s();
+  const Velocity& v = ac.get_v();
+  const SUMData& sum = ac.sum();
+  sx.push_back(s.x); sy.push_back(s.y); sz.push_back(s.z);
+  vx.push_back(v.x); vy.push_back(v.y); vz.push_back(v.z);
+  s_EW_std.push_back(sum.get_s_EW_std());
+  s_NS_std.push_back(sum.get_s_NS_std());
+  s_EN_std.push_back(sum.get_s_EN_std());
+  sz_std.push_back(sum.get_sz_std());
+  v_EW_std.push_back(sum.get_v_EW_std());
+  v_NS_std.push_back(sum.get_v_NS_std());
+  v_EN_std.push_back(sum.get_v_EN_std());
+  vz_std.push_back(sum.get_vz_std());
+  slot.push_back(ac_slot);
+}
+
+/**
+ * Returns structure-of-arrays view of the traffic list, indexed as traffic. Traffic states
+ * are already projected with respect to the ownship, so the view is built by copying
+ * projected values the first time it's requested after cached values become stale. It's only
+ * built on request since bands and alerting read traffic states directly.
+ */
+const DaidalusCore::TrafficArrays& DaidalusCore::traffic_arrays() const {
+  std::lock_guard<std::mutex> lock(traffic_arrays_mutex_);
+  if (!traffic_arrays_fresh_) {
+    traffic_arrays_.clear();
+    for (int ac = 0; ac < static_cast<int>(traffic.size()); ++ac) {
+      traffic_arrays_.push_back(traffic[ac],traffic_slots_[ac]);
+    }
+    traffic_arrays_fresh_ = true;
+  }
+  return traffic_arrays_;
+}
+
 /**
  *  Refresh cached values
  */
@@ -210,12 +383,12 @@ void DaidalusCore::refresh() {
     dta_status_ = 0; // Not active
     if (parameters.getDTALogic() != 0 && parameters.getDTAAlerter() != 0) {
       if (parameters.isAlertingLogicOwnshipCentric()) {
-        if (alerter_index_of(ownship) == parameters.getDTAAlerter()) {
+        if (alerter_index_of(ownship_slot_,ownship) == parameters.getDTAAlerter()) {
           dta_status_ = -1; // Inside DTA
         }
       } else {
         for (int ac=0; ac < static_cast<int>(traffic.size()) && dta_status_ == 0; ++ac) {
-          if (alerter_index_of(traffic[ac]) == parameters.getDTAAlerter()) {
+          if (traffic_alerter_index(ac) == parameters.getDTAAlerter()) {
             dta_status_ = -1; // Inside DTA
           }
         }
@@ -351,20 +524,58 @@ double DaidalusCore::minVerticalRecovery() const {
 
 void DaidalusCore::set_ownship_state(const std::string& id, const Position& pos, const Velocity& vel, double time) {
   traffic.clear();
+  traffic_update_time_.clear();
+  traffic_slots_.clear();
+  slot_traffic_idx_.assign(slot_ids_.size(),-1);
+  ownship_slot_ = intern_slot(id);
   ownship = TrafficState::makeOwnship(id,pos,vel);
   ownship.applyWindVector(wind_vector);
   current_time = time;
   stale();
 }
 
-// Return 0-based index in traffic list (-1 if aircraft doesn't exist)
-int DaidalusCore::find_traffic_state(const std::string& id) const {
+/**
+ * Incremental version of set_ownship_state. Traffic aircraft are kept, linearly projected to
+ * the new current time, and set as intruders of the new ownship. Requires time >= current_time.
+ * As in set_traffic_state, traffic aircraft whose position is not of the same kind as the
+ * ownship's, i.e., lat/lon or Euclidean, are removed.
+ */
+void DaidalusCore::update_ownship_state(const std::string& id, const Position& pos, const Velocity& vel, double time) {
+  double dt = time-current_time;
+  ownship_slot_ = intern_slot(id);
+  ownship = TrafficState::makeOwnship(id,pos,vel);
+  ownship.applyWindVector(wind_vector);
+  current_time = time;
+  int kept = 0;
   for (int i = 0; i < static_cast<int>(traffic.size()); ++i) {
-    if (equals(traffic[i].getId(),id)) {
-      return i;
+    TrafficState& ac = traffic[i];
+    if (ac.isLatLon() != ownship.isLatLon()) {
+      clear_slot_hysteresis(traffic_slots_[i]);
+      continue;
+    }
+    Position pt = dt == 0 ? ac.getPosition() : ac.getPosition().linear(ac.getGroundVelocity(),dt);
+    ac.setStateAsIntruderOf(pt,ac.getGroundVelocity(),ownship);
+    if (kept != i) {
+      traffic[kept] = traffic[i];
+      traffic_update_time_[kept] = traffic_update_time_[i];
+      traffic_slots_[kept] = traffic_slots_[i];
     }
+    ++kept;
   }
-  return -1;
+  if (kept < static_cast<int>(traffic.size())) {
+    traffic.resize(kept);
+    traffic_update_time_.resize(kept);
+    traffic_slots_.resize(kept);
+    reindex_traffic_slots();
+    compact_slots();
+  }
+  stale();
+}
+
+// Return 0-based index in traffic list (-1 if aircraft doesn't exist)
+int DaidalusCore::find_traffic_state(const std::string& id) const {
+  int slot = find_slot(id);
+  return slot >= 0 ? slot_traffic_idx_[slot] : -1;
 }
 
 // Return 0-based index in traffic list where aircraft was added. Return -1 if
@@ -381,9 +592,14 @@ int DaidalusCore::set_traffic_state(const std::string& id, const Position& pos,
     int idx = find_traffic_state(id);
     if (idx >= 0) {
       traffic[idx]=ac;
+      traffic_update_time_[idx]=time;
     } else {
       idx = traffic.size();
+      int slot = intern_slot(id);
       traffic.push_back(ac);
+      traffic_update_time_.push_back(time);
+      traffic_slots_.push_back(slot);
+      slot_traffic_idx_[slot] = idx;
     }
     stale();
     return idx;
@@ -392,6 +608,49 @@ int DaidalusCore::set_traffic_state(const std::string& id, const Position& pos,
   }
 }
 
+// idx is 0-based index in traffic list. Update position and velocity of aircraft at idx, keeping
+// its identifier, alerter, and SUM data. Return false if idx is out of range or state is not valid.
+bool DaidalusCore::update_traffic_state(int idx, const Position& pos, const Velocity& vel, double time) {
+  if (0 <= idx && idx < static_cast<int>(traffic.size()) &&
+      !pos.isInvalid() && !vel.isInvalid() && pos.isLatLon() == ownship.isLatLon()) {
+    double dt = current_time-time;
+    Position pt = dt == 0 ? pos : pos.linear(vel,dt);
+    traffic[idx].setStateAsIntruderOf(pt,vel,ownship);
+    traffic_update_time_[idx] = time;
+    stale();
+    return true;
+  }
+  return false;
+}
+
+// Remove traffic aircraft whose states were last set before current_time-max_age.
+// Return number of removed aircraft.
+int DaidalusCore::remove_stale_traffic(double max_age) {
+  int kept = 0;
+  for (int i = 0; i < static_cast<int>(traffic.size()); ++i) {
+    if (traffic_update_time_[i] < current_time-max_age) {
+      clear_slot_hysteresis(traffic_slots_[i]);
+    } else {
+      if (kept != i) {
+        traffic[kept] = traffic[i];
+        traffic_update_time_[kept] = traffic_update_time_[i];
+        traffic_slots_[kept] = traffic_slots_[i];
+      }
+      ++kept;
+    }
+  }
+  int removed = traffic.size()-kept;
+  if (removed > 0) {
+    traffic.resize(kept);
+    traffic_update_time_.resize(kept);
+    traffic_slots_.resize(kept);
+    reindex_traffic_slots();
+    compact_slots();
+    stale();
+  }
+  return removed;
+}
+
 // idx is 0-based index in traffic list
 void DaidalusCore::reset_ownship(int idx) {
   TrafficState old_own = ownship;
@@ -401,19 +660,25 @@ void DaidalusCore::reset_ownship(int idx) {
   for (int i = 0; i < static_cast<int>(traffic.size()); ++i) {
     if (i == idx) {
       traffic[i] = old_own;
+      traffic_update_time_[i] = current_time;
     } else {
       traffic[i].setAsIntruderOf(ownship);
     }
   }
+  std::swap(ownship_slot_,traffic_slots_[idx]);
+  reindex_traffic_slots();
   stale();
 }
 
 // idx is 0-based index in traffic list
 bool DaidalusCore::remove_traffic(int idx) {
   if (0 <= idx && idx < static_cast<int>(traffic.size())) {
-    dta_hysteresis_acs_.erase(traffic[idx].getId());
-    alerting_hysteresis_acs_.erase(traffic[idx].getId());
+    clear_slot_hysteresis(traffic_slots_[idx]);
     traffic.erase(traffic.begin()+idx);
+    traffic_update_time_.erase(traffic_update_time_.begin()+idx);
+    traffic_slots_.erase(traffic_slots_.begin()+idx);
+    reindex_traffic_slots();
+    compact_slots();
     stale();
     return true;
   }
@@ -462,7 +727,7 @@ bool DaidalusCore::has_traffic() const {
  */
 int DaidalusCore::horizontal_contours(std::vector<std::vector<Position> >& blobs, int idx, int alert_level) {
   const TrafficState& intruder = traffic[idx];
-  int alerter_idx = alerter_index_of(intruder);
+  int alerter_idx = traffic_alerter_index(idx);
   if (1 <= alerter_idx && alerter_idx <= parameters.numberOfAlerters()) {
     const Alerter& alerter = parameters.getAlerterAt(alerter_idx);
     if (alert_level == 0) {
@@ -495,7 +760,7 @@ int DaidalusCore::horizontal_contours(std::vector<std::vector<Position> >& blobs
 int DaidalusCore::horizontal_hazard_zone(std::vector<Position>& haz, int idx, int alert_level,
     bool loss, bool from_ownship) {
   const TrafficState& intruder = traffic[idx];
-  int alerter_idx = alerter_index_of(intruder);
+  int alerter_idx = traffic_alerter_index(idx);
   if (1 <= alerter_idx && alerter_idx <= parameters.numberOfAlerters()) {
     const Alerter& alerter = parameters.getAlerterAt(alerter_idx);
     if (alert_level == 0) {
@@ -520,6 +785,172 @@ int DaidalusCore::horizontal_hazard_zone(std::vector<Position>& haz, int idx, in
   return 0;
 }
 
+/**
+ * Returns a copy of the ownship state with ground velocity vel. The wind vector is applied
+ * to vel. The copy shares the Euclidean projection of the ownship. Therefore, it can be
+ * used with the current traffic states without projecting them again.
+ */
+TrafficState DaidalusCore::ownship_with_velocity(const Velocity& vel) const {
+  TrafficState own = ownship;
+  own.setAirVelocity(Velocity(vel.Sub(wind_vector)));
+  return own;
+}
+
+/* idx is a 0-based index in the list of traffic aircraft
+ * Detection of alert thresholds for given alert level between own, a hypothetical ownship state,
+ * and the idx-th aircraft in the traffic list. An alert level 0 means the corrective alert level.
+ * This method doesn't modify cached values nor hysteresis variables.
+ * returns 1 if detector of traffic aircraft is not set
+ * returns 2 if corrective alerter level is not set
+ * returns 3 if alerter of traffic aircraft is out of bands
+ * otherwise, if there are no errors, returns 0 and the answer is in det
+ */
+int DaidalusCore::violation_of_alert_thresholds(ConflictData& det, const TrafficState& own, int idx, int alert_level) const {
+  const TrafficState& intruder = traffic[idx];
+  int alerter_idx = current_alerter_index_of(traffic_slots_[idx],intruder);
+  if (1 <= alerter_idx && alerter_idx <= parameters.numberOfAlerters()) {
+    const Alerter& alerter = parameters.getAlerterAt(alerter_idx);
+    if (alert_level == 0) {
+      alert_level = alerter.alertLevelForRegion(parameters.getCorrectiveRegion());
+    }
+    if (alert_level > 0) {
+      Detection3D* detector = alerter.getDetectorPtr(alert_level);
+      if (detector != NULL) {
+        det = detector->conflictDetectionWithTrafficState(own,intruder,0.0,parameters.getLookaheadTime());
+      } else {
+        return 1;
+      }
+    } else {
+      return 2;
+    }
+  } else {
+    return 3;
+  }
+  return 0;
+}
+
+/**
+ * Conflict detection between ownship and the idx-th aircraft in the traffic list, using detector
+ * over the time interval [B,T]. The result is cached until cached values are stale.
+ * Requires 0 <= idx < traffic.size()
+ */
+ConflictData DaidalusCore::conflict_detection(const Detection3D* detector, int idx, double B, double T) {
+  {
+    std::lock_guard<std::mutex> lock(detections_mutex_);
+    if (detections_.size() < traffic.size()) {
+      detections_.resize(traffic.size());
+    }
+    const std::vector<CachedDetection>& cached = detections_[idx];
+    for (int i = 0; i < static_cast<int>(cached.size()); ++i) {
+      if (cached[i].detector == detector && cached[i].B == B && cached[i].T == T) {
+        return cached[i].det;
+      }
+    }
+  }
+  // Detection is computed without holding the lock
+  CachedDetection entry;
+  entry.detector = detector;
+  entry.B = B;
+  entry.T = T;
+  entry.det = detector->conflictDetectionWithTrafficState(ownship,traffic[idx],B,T);
+  std::lock_guard<std::mutex> lock(detections_mutex_);
+  detections_[idx].push_back(entry);
+  return entry.det;
+}
+
+/**
+ * Upper bound of the horizontal air speed of the ownship over all maneuvers considered by
+ * alerting and bands. Direction maneuvers keep either the ground speed or the air speed, and speed
+ * maneuvers are bounded by the maximum horizontal speed, which may be a ground speed.
+ */
+double DaidalusCore::max_ownship_speed() const {
+  double wind = ownship.windVector().gs();
+  return Util::max(ownship.get_v().gs(),
+      Util::max(ownship.getGroundVelocity().gs(),parameters.getMaxHorizontalSpeed())+wind);
+}
+
+/**
+ * Return true if the idx-th aircraft in the traffic list can't be in conflict with the ownship, using
+ * detector, within time T, when the horizontal air speed of the ownship is at most max_own_speed.
+ * The horizontal distance between the aircraft decreases at most at their maximum relative speed, so
+ * the aircraft are out of range if they can't get within the horizontal violation range of the detector
+ * by time T.
+ */
+bool DaidalusCore::out_of_range(const Detection3D* detector, int idx, double max_own_speed, double T) const {
+  const TrafficState& intruder = traffic[idx];
+  // A 10% margin on the relative speed accounts for differences between projected and geodesic trajectories
+  double vh = 1.1*(max_own_speed+intruder.get_v().gs());
+  double range = detector->horizontalViolationRange(vh);
+  if (ISINF(range)) {
+    return false;
+  }
+  Vect2 s = ownship.get_s().vect2().Sub(intruder.get_s().vect2());
+  return s.norm() > range+vh*T;
+}
+
+/**
+ * Batched what-if detection of corrective thresholds for a list of hypothetical ownship ground
+ * velocities. For the k-th velocity, tin[k] is the earliest time to violation of the corrective
+ * volume with any traffic aircraft and tcpa[k] is the minimum time to horizontal closest point of
+ * approach among the traffic aircraft in conflict. Both values are POSITIVE_INFINITY when there is no
+ * conflict. Alerters, detectors, and relative positions are resolved once per traffic aircraft and
+ * reused for all velocities. This method doesn't modify cached values nor hysteresis variables.
+ */
+void DaidalusCore::corrective_conflicts(std::vector<double>& tin, std::vector<double>& tcpa, const std::vector<Velocity>& vels) const {
+  tin.assign(vels.size(),PINFINITY);
+  tcpa.assign(vels.size(),PINFINITY);
+  if (!has_ownship() || vels.empty()) {
+    return;
+  }
+  const TrafficArrays& arrays = traffic_arrays();
+  const Vect3& so = ownship.get_s();
+  double T = parameters.getLookaheadTime();
+  std::vector<TrafficState> owns;
+  owns.reserve(vels.size());
+  double max_own_speed = 0;
+  for (int k = 0; k < static_cast<int>(vels.size()); ++k) {
+    owns.push_back(ownship_with_velocity(vels[k]));
+    max_own_speed = Util::max(max_own_speed,owns[k].get_v().gs());
+  }
+  // Per traffic aircraft: corrective detector and horizontal relative position
+  std::vector<const TrafficState*> acs;
+  std::vector<const Detection3D*> detectors;
+  std::vector<Vect2> rel_s;
+  std::vector<Vect2> vi;
+  for (int ac = 0; ac < static_cast<int>(traffic.size()); ++ac) {
+    const TrafficState& intruder = traffic[ac];
+    int alerter_idx = current_alerter_index_of(traffic_slots_[ac],intruder);
+    if (1 <= alerter_idx && alerter_idx <= parameters.numberOfAlerters()) {
+      const Alerter& alerter = parameters.getAlerterAt(alerter_idx);
+      int alert_level = alerter.alertLevelForRegion(parameters.getCorrectiveRegion());
+      if (alert_level > 0) {
+        const Detection3D* detector = alerter.getDetectorPtr(alert_level);
+        if (detector != NULL && !out_of_range(detector,ac,max_own_speed,T)) {
+          acs.push_back(&intruder);
+          detectors.push_back(detector);
+          rel_s.push_back(Vect2(so.x-arrays.sx[ac],so.y-arrays.sy[ac]));
+          vi.push_back(Vect2(arrays.vx[ac],arrays.vy[ac]));
+        }
+      }
+    }
+  }
+  // Each traffic aircraft is checked against all velocities in one batch
+  std::vector<ConflictData> dets;
+  for (int i = 0; i < static_cast<int>(acs.size()); ++i) {
+    detectors[i]->conflictDetectionWithTrafficStates(dets,owns,*acs[i],0.0,T);
+    for (int k = 0; k < static_cast<int>(vels.size()); ++k) {
+      const ConflictData& det = dets[k];
+      if (det.conflict()) {
+        tin[k] = Util::min(tin[k],det.getTimeIn());
+        double t = Util::max(0.0,Horizontal::tcpa(rel_s[i],owns[k].get_v().vect2().Sub(vi[i])));
+        if (t <= tcpa[k]) {
+          tcpa[k] = t;
+        }
+      }
+    }
+  }
+}
+
 /**
  * Requires 0 <= conflict_region < CONFICT_BANDS
  * Put in acs_conflict_bands_ the list of aircraft predicted to be in conflict for the given region.
@@ -529,10 +960,12 @@ int DaidalusCore::horizontal_hazard_zone(std::vector<Position>& haz, int idx, in
 void DaidalusCore::conflict_aircraft(int conflict_region) {
   double tin  = PINFINITY;
   double tout = NINFINITY;
+  double max_own_speed = max_ownship_speed();
   // Iterate on all traffic aircraft
   for (int ac = 0; ac < static_cast<int>(traffic.size()); ++ac) {
     const TrafficState& intruder = traffic[ac];
-    int alerter_idx = alerter_index_of(intruder);
+    int slot = traffic_slots_[ac];
+    int alerter_idx = alerter_index_of(slot,intruder);
     if (1 <= alerter_idx && alerter_idx <= parameters.numberOfAlerters()) {
       const Alerter& alerter = parameters.getAlerterAt(alerter_idx);
       // Assumes that thresholds of severe alerts are included in the volume of less severe alerts
@@ -540,16 +973,16 @@ void DaidalusCore::conflict_aircraft(int conflict_region) {
       int alert_level = alerter.alertLevelForRegion(region);
       if (alert_level > 0) {
         Detection3D* detector =  alerter.getLevel(alert_level).getCoreDetectionPtr();
-        if (detector != NULL) {
-          std::map<std::string,HysteresisData>::iterator alerting_hysteresis_ptr = alerting_hysteresis_acs_.find(intruder.getId());
+        if (detector != NULL && !out_of_range(detector,ac,max_own_speed,parameters.getLookaheadTime())) {
+          const HysteresisData& alerting_hysteresis = alerting_hysteresis_acs_[slot];
           double alerting_time = alerter.getLevel(alert_level).getAlertingTime();
-          if (alerting_hysteresis_ptr != alerting_hysteresis_acs_.end() &&
-              !ISNAN(alerting_hysteresis_ptr->second.getInitTime()) &&
-              alerting_hysteresis_ptr->second.getInitTime() < current_time &&
-              alerting_hysteresis_ptr->second.getLastValue() == alert_level) {
+          if (alerting_hysteresis_set_[slot] &&
+              !ISNAN(alerting_hysteresis.getInitTime()) &&
+              alerting_hysteresis.getInitTime() < current_time &&
+              alerting_hysteresis.getLastValue() == alert_level) {
             alerting_time = alerter.getLevel(alert_level).getEarlyAlertingTime();
           }
-          ConflictData det = detector->conflictDetectionWithTrafficState(ownship,intruder,0.0,parameters.getLookaheadTime());
+          ConflictData det = conflict_detection(detector,ac,0.0,parameters.getLookaheadTime());
           if (det.conflict()) {
             if (det.conflictBefore(alerting_time)) {
               acs_conflict_bands_[conflict_region].push_back(IndexLevelT(ac,alert_level,parameters.getLookaheadTime()));
@@ -586,28 +1019,41 @@ const Interval& DaidalusCore::tiov(int conflict_region) {
   return tiov_[conflict_region];
 }
 
-int DaidalusCore::dta_hysteresis_current_value(const TrafficState& ac) {
+int DaidalusCore::raw_dta_status(const TrafficState& ac) const {
+  return Util::almost_leq(ac.getPosition().distanceH(parameters.getDTAPosition()),parameters.getDTARadius()) &&
+      Util::almost_leq(ac.getPosition().alt(),parameters.getDTAHeight()) ? 1 : 0;
+}
+
+int DaidalusCore::dta_hysteresis_current_value(int slot, const TrafficState& ac) {
   if (parameters.getDTALogic() != 0 && parameters.getDTAAlerter() != 0 &&
       parameters.getDTARadius() > 0 && parameters.getDTAHeight() > 0) {
-    std::map<std::string,HysteresisData>::iterator dta_hysteresis_ptr = dta_hysteresis_acs_.find(ac.getId());
-    if (dta_hysteresis_ptr ==  dta_hysteresis_acs_.end()) {
-      HysteresisData dta_hysteresis = HysteresisData(
+    HysteresisData& dta_hysteresis = dta_hysteresis_acs_[slot];
+    if (!dta_hysteresis_set_[slot]) {
+      dta_hysteresis = HysteresisData(
           parameters.getHysteresisTime(),
           parameters.getPersistenceTime(),
           parameters.getAlertingParameterM(),
           parameters.getAlertingParameterN());
-      int raw_dta = Util::almost_leq(ac.getPosition().distanceH(parameters.getDTAPosition()),parameters.getDTARadius()) &&
-          Util::almost_leq(ac.getPosition().alt(),parameters.getDTAHeight()) ? 1 : 0;
-      int actual_dta = dta_hysteresis.applyHysteresisLogic(raw_dta,current_time);
-      dta_hysteresis_acs_[ac.getId()] = dta_hysteresis;
-      return actual_dta;
-    } else if (dta_hysteresis_ptr->second.isUpdatedAtCurrentTime(current_time)) {
-      return dta_hysteresis_ptr->second.getLastValue();
+      dta_hysteresis_set_[slot] = true;
+      return dta_hysteresis.applyHysteresisLogic(raw_dta_status(ac),current_time);
+    } else if (dta_hysteresis.isUpdatedAtCurrentTime(current_time)) {
+      return dta_hysteresis.getLastValue();
     } else {
-      int raw_dta = Util::almost_leq(ac.getPosition().distanceH(parameters.getDTAPosition()),parameters.getDTARadius()) &&
-          Util::almost_leq(ac.getPosition().alt(),parameters.getDTAHeight()) ? 1 : 0;
-      return dta_hysteresis_ptr->second.applyHysteresisLogic(raw_dta,current_time);
+      return dta_hysteresis.applyHysteresisLogic(raw_dta_status(ac),current_time);
+    }
+  } else {
+    return 0;
+  }
+}
+
+int DaidalusCore::dta_hysteresis_last_value(int slot, const TrafficState& ac) const {
+  if (parameters.getDTALogic() != 0 && parameters.getDTAAlerter() != 0 &&
+      parameters.getDTARadius() > 0 && parameters.getDTAHeight() > 0) {
+    if (slot >= 0 && dta_hysteresis_set_[slot] &&
+        dta_hysteresis_acs_[slot].isUpdatedAtCurrentTime(current_time)) {
+      return dta_hysteresis_acs_[slot].getLastValue();
     }
+    return raw_dta_status(ac);
   } else {
     return 0;
   }
@@ -619,17 +1065,62 @@ int DaidalusCore::dta_hysteresis_current_value(const TrafficState& ac) {
  * If ownship centric, it returns the alert index of ownship.
  * Otherwise, returns the alert index of the intruder.
  * If the DTA logic is enabled, the alerter of an aircraft is determined by
- * its dta status.
+ * its dta status. If the aircraft is neither the ownship nor a traffic aircraft
+ * seen before, its raw dta status is used and no hysteresis is created for it.
  */
 int DaidalusCore::alerter_index_of(const TrafficState& intruder) {
+  int slot = find_slot(intruder.getId());
+  if (slot < 0) {
+    // Unknown aircraft don't get a slot, so their DTA status is the raw one
+    return current_alerter_index_of(slot,intruder);
+  }
+  return alerter_index_of(slot,intruder);
+}
+
+/**
+ * Same as alerter_index_of, where idx is a 0-based index in the list of traffic aircraft.
+ * Requires 0 <= idx < traffic.size()
+ */
+int DaidalusCore::traffic_alerter_index(int idx) {
+  return alerter_index_of(traffic_slots_[idx],traffic[idx]);
+}
+
+// slot is the slot of intruder
+int DaidalusCore::alerter_index_of(int slot, const TrafficState& intruder) {
+  if (parameters.isAlertingLogicOwnshipCentric()) {
+    if (dta_hysteresis_current_value(ownship_slot_,ownship) == 1) {
+      return parameters.getDTAAlerter();
+    } else {
+      return ownship.getAlerterIndex();
+    }
+  } else {
+    if (dta_hysteresis_current_value(slot,intruder) == 1) {
+      return parameters.getDTAAlerter();
+    } else {
+      return intruder.getAlerterIndex();
+    }
+  }
+}
+
+/**
+ * Same as alerter_index_of, but DTA hysteresis is not updated. If DTA hysteresis
+ * was already applied at current time, its last value is used. Otherwise, the raw DTA
+ * status of the aircraft is used.
+ */
+int DaidalusCore::current_alerter_index_of(const TrafficState& intruder) const {
+  return current_alerter_index_of(find_slot(intruder.getId()),intruder);
+}
+
+// slot is the slot of intruder (-1 if intruder has no slot)
+int DaidalusCore::current_alerter_index_of(int slot, const TrafficState& intruder) const {
   if (parameters.isAlertingLogicOwnshipCentric()) {
-    if (dta_hysteresis_current_value(ownship) == 1) {
+    if (dta_hysteresis_last_value(ownship_slot_,ownship) == 1) {
       return parameters.getDTAAlerter();
     } else {
       return ownship.getAlerterIndex();
     }
   } else {
-    if (dta_hysteresis_current_value(intruder) == 1) {
+    if (dta_hysteresis_last_value(slot,intruder) == 1) {
       return parameters.getDTAAlerter();
     } else {
       return intruder.getAlerterIndex();
@@ -665,24 +1156,69 @@ TrafficState DaidalusCore::recovery_ac() {
   return parameters.isEnabledRecoveryCriteria() ? mostUrgentAircraft() : TrafficState::INVALID();
 }
 
+/**
+ * Return the alerting time of an alerting level. The early alerting time is used when the
+ * alert level of the intruder at the previous time is the given one.
+ */
+double DaidalusCore::alerting_time_of(const Alerter& alerter, int alert_level, int slot) const {
+  const HysteresisData& alerting_hysteresis = alerting_hysteresis_acs_[slot];
+  if (alerting_hysteresis_set_[slot] &&
+      !ISNAN(alerting_hysteresis.getLastTime()) &&
+      alerting_hysteresis.getLastTime() < current_time &&
+      alerting_hysteresis.getLastValue() == alert_level) {
+    return alerter.getLevel(alert_level).getEarlyAlertingTime();
+  }
+  return alerter.getLevel(alert_level).getAlertingTime();
+}
+
+/**
+ * Return true if the thresholds of alerting level 1 contain the thresholds of every more severe
+ * level, i.e., if the detector of level 1 contains the detector of every other level and
+ * alerting time and spreads of level 1 are greater than or equal to the ones of every other level.
+ * In this case, a level can't be violated when level 1 isn't.
+ */
+bool DaidalusCore::nested_alert_levels(const Alerter& alerter, int slot) const {
+  const AlertThresholds& athr1 = alerter.getLevel(1);
+  if (!athr1.isValid()) {
+    return false;
+  }
+  const Detection3D* detector1 = athr1.getCoreDetectionPtr();
+  double alerting_time1 = alerting_time_of(alerter,1,slot);
+  for (int alert_level=2; alert_level <= alerter.mostSevereAlertLevel(); ++alert_level) {
+    const AlertThresholds& athr = alerter.getLevel(alert_level);
+    if (!athr.isValid()) {
+      continue;
+    }
+    const Detection3D* detector = athr.getCoreDetectionPtr();
+    if ((detector != detector1 && !detector1->contains(detector)) ||
+        alerting_time1 < alerting_time_of(alerter,alert_level,slot) ||
+        athr1.getHorizontalDirectionSpread() < athr.getHorizontalDirectionSpread() ||
+        athr1.getHorizontalSpeedSpread() < athr.getHorizontalSpeedSpread() ||
+        athr1.getVerticalSpeedSpread() < athr.getVerticalSpeedSpread() ||
+        athr1.getAltitudeSpread() < athr.getAltitudeSpread()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 /**
  * Return true if and only if threshold values, defining an alerting level, are violated.
  */
-bool DaidalusCore::check_alerting_thresholds(const Alerter& alerter, int alert_level, const TrafficState& intruder, int turning, int accelerating, int climbing) {
+bool DaidalusCore::check_alerting_thresholds(const Alerter& alerter, int alert_level, int slot, const TrafficState& intruder, int turning, int accelerating, int climbing) {
   const AlertThresholds& athr = alerter.getLevel(alert_level);
   if (athr.isValid()) {
     Detection3D* detector = athr.getCoreDetectionPtr();
-    std::map<std::string,HysteresisData>::iterator alerting_hysteresis_ptr = alerting_hysteresis_acs_.find(intruder.getId());
-    double alerting_time = alerter.getLevel(alert_level).getAlertingTime();
-    if (alerting_hysteresis_ptr != alerting_hysteresis_acs_.end() &&
-        !ISNAN(alerting_hysteresis_ptr->second.getLastTime()) &&
-        alerting_hysteresis_ptr->second.getLastTime() < current_time &&
-        alerting_hysteresis_ptr->second.getLastValue() == alert_level) {
-      alerting_time = alerter.getLevel(alert_level).getEarlyAlertingTime();
+    double alerting_time = alerting_time_of(alerter,alert_level,slot);
+    int idx = slot_traffic_idx_[slot];
+    if (idx >= 0 && out_of_range(detector,idx,max_ownship_speed(),
+        Util::max(parameters.getLookaheadTime(),alerting_time))) {
+      return false;
     }
     int epsh = epsilonH(false,intruder);
     int epsv = epsilonV(false,intruder);
-    ConflictData det = detector->conflictDetectionWithTrafficState(ownship,intruder,0.0,parameters.getLookaheadTime());
+    ConflictData det = idx >= 0 ? conflict_detection(detector,idx,0.0,parameters.getLookaheadTime()) :
+        detector->conflictDetectionWithTrafficState(ownship,intruder,0.0,parameters.getLookaheadTime());
     if (det.conflictBefore(alerting_time)) {
       return true;
     }
@@ -725,27 +1261,27 @@ bool DaidalusCore::check_alerting_thresholds(const Alerter& alerter, int alert_l
   return false;
 }
 
-int DaidalusCore::alerting_hysteresis_current_value(const TrafficState& intruder, int turning, int accelerating, int climbing) {
-  int alerter_idx = alerter_index_of(intruder);
+int DaidalusCore::alerting_hysteresis_current_value(int slot, const TrafficState& intruder, int turning, int accelerating, int climbing) {
+  int alerter_idx = alerter_index_of(slot,intruder);
   if (1 <= alerter_idx && alerter_idx <= parameters.numberOfAlerters()) {
-    std::map<std::string,HysteresisData>::iterator alerting_hysteresis_ptr = alerting_hysteresis_acs_.find(intruder.getId());
-    if (alerting_hysteresis_ptr == alerting_hysteresis_acs_.end()) {
+    if (!alerting_hysteresis_set_[slot]) {
       HysteresisData alerting_hysteresis = HysteresisData(
           parameters.getHysteresisTime(),
           parameters.getPersistenceTime(),
           parameters.getAlertingParameterM(),
           parameters.getAlertingParameterN());
       const Alerter& alerter = parameters.getAlerterAt(alerter_idx);
-      int raw_alert = raw_alert_level(alerter,intruder,turning,accelerating,climbing);
+      int raw_alert = raw_alert_level(alerter,slot,intruder,turning,accelerating,climbing);
       int actual_alert = alerting_hysteresis.applyHysteresisLogic(raw_alert,current_time);
-      alerting_hysteresis_acs_[intruder.getId()] = alerting_hysteresis;
+      alerting_hysteresis_acs_[slot] = alerting_hysteresis;
+      alerting_hysteresis_set_[slot] = true;
       return actual_alert;
-    } else if (alerting_hysteresis_ptr->second.isUpdatedAtCurrentTime(current_time)) {
-      return alerting_hysteresis_ptr->second.getLastValue();
+    } else if (alerting_hysteresis_acs_[slot].isUpdatedAtCurrentTime(current_time)) {
+      return alerting_hysteresis_acs_[slot].getLastValue();
     } else {
       const Alerter& alerter = parameters.getAlerterAt(alerter_idx);
-      int raw_alert = raw_alert_level(alerter,intruder,turning,accelerating,climbing);
-      return alerting_hysteresis_ptr->second.applyHysteresisLogic(raw_alert,current_time);
+      int raw_alert = raw_alert_level(alerter,slot,intruder,turning,accelerating,climbing);
+      return alerting_hysteresis_acs_[slot].applyHysteresisLogic(raw_alert,current_time);
     }
   } else {
     return -1;
@@ -771,19 +1307,28 @@ int DaidalusCore::alerting_hysteresis_current_value(const TrafficState& intruder
  */
 int DaidalusCore::alert_level(int idx, int turning, int accelerating, int climbing) {
   if (0 <= idx && idx < static_cast<int>(traffic.size())) {
-    return alerting_hysteresis_current_value(traffic[idx],turning,accelerating,climbing);
+    return alerting_hysteresis_current_value(traffic_slots_[idx],traffic[idx],turning,accelerating,climbing);
   } else {
     return -1;
   }
 }
 
-int DaidalusCore::raw_alert_level(const Alerter& alerter, const TrafficState& intruder, int turning, int accelerating, int climbing) {
-  for (int alert_level=alerter.mostSevereAlertLevel(); alert_level > 0; --alert_level) {
-    if (check_alerting_thresholds(alerter,alert_level,intruder,turning,accelerating,climbing)) {
+int DaidalusCore::raw_alert_level(const Alerter& alerter, int slot, const TrafficState& intruder, int turning, int accelerating, int climbing) {
+  if (alerter.mostSevereAlertLevel() <= 0) {
+    return 0;
+  }
+  // Level 1 is checked first. Most intruders don't violate it and, when alerting levels are nested,
+  // the more severe levels don't need to be checked.
+  bool level1 = check_alerting_thresholds(alerter,1,slot,intruder,turning,accelerating,climbing);
+  if (!level1 && nested_alert_levels(alerter,slot)) {
+    return 0;
+  }
+  for (int alert_level=alerter.mostSevereAlertLevel(); alert_level > 1; --alert_level) {
+    if (check_alerting_thresholds(alerter,alert_level,slot,intruder,turning,accelerating,climbing)) {
       return alert_level;
     }
   }
-  return 0;
+  return level1 ? 1 : 0;
 }
 
 std::string DaidalusCore::outputStringAircraftStates(bool internal) const {
@@ -843,22 +1388,28 @@ std::string DaidalusCore::rawString() const {
     s += Fmb(bands4region_[conflict_region]);
   }
   s += "}\n";
-  std::map<std::string,HysteresisData>::const_iterator entry_ptr = alerting_hysteresis_acs_.begin();
-  while (entry_ptr != alerting_hysteresis_acs_.end()) {
-    s+="alerting_hysteresis_acs_["+entry_ptr->first+"] = "+
-        entry_ptr->second.toString();
-    ++entry_ptr;
+  // Hysteresis values are listed in order of aircraft identifiers
+  bool nonempty = false;
+  std::map<std::string,int>::const_iterator entry_ptr;
+  for (entry_ptr = slots_.begin(); entry_ptr != slots_.end(); ++entry_ptr) {
+    if (alerting_hysteresis_set_[entry_ptr->second]) {
+      s+="alerting_hysteresis_acs_["+entry_ptr->first+"] = "+
+          alerting_hysteresis_acs_[entry_ptr->second].toString();
+      nonempty = true;
+    }
   }
-  if (!alerting_hysteresis_acs_.empty()) {
+  if (nonempty) {
     s+="\n";
   }
-  entry_ptr = dta_hysteresis_acs_.begin();
-  while (entry_ptr != dta_hysteresis_acs_.end()) {
-    s+="dta_hysteresis_acs_["+entry_ptr->first+"] = "+
-        entry_ptr->second.toString();
-    ++entry_ptr;
+  nonempty = false;
+  for (entry_ptr = slots_.begin(); entry_ptr != slots_.end(); ++entry_ptr) {
+    if (dta_hysteresis_set_[entry_ptr->second]) {
+      s+="dta_hysteresis_acs_["+entry_ptr->first+"] = "+
+          dta_hysteresis_acs_[entry_ptr->second].toString();
+      nonempty = true;
+    }
   }
-  if (!dta_hysteresis_acs_.empty()) {
+  if (nonempty) {
     s+="\n";
   }
   s+="wind_vector = "+wind_vector.toString()+"\n";
@@ -84,5 +84,52 @@ double DaidalusDirBands::max_delta_resolution(const DaidalusParameters& paramete
   return parameters.getPersistencePreferredHorizontalDirectionResolution();
 }
 
+// Ownship state used by CD_future_traj in instantaneous bands when the ownship direction is trk
+TrafficState DaidalusDirBands::instantaneous_ownship(const TrafficState& ownship, double trk) const {
+  TrafficState own = ownship;
+  own.setPosition(Position(ownship.pos_to_s(ownship.positionXYZ())));
+  own.setAirVelocity(ownship.vel_to_v(ownship.positionXYZ(),ownship.velocityXYZ().mkTrk(trk)));
+  return own;
+}
+
+// Critical steps are computed from the critical angles of the detector. Ownship velocities for all directions
+// have to be a circle, which is traversed clockwise as the direction increases.
+bool DaidalusDirBands::instantaneous_critical_steps(std::vector<double>& steps, const Detection3D* det, double B, double T,
+    bool trajdir, const DaidalusParameters& parameters, const TrafficState& ownship, const TrafficState& traffic) const {
+  T = Util::min(parameters.getLookaheadTime(),T);
+  if (B > T) {
+    return true;
+  }
+  if (Util::almost_equals(B,T)) {
+    return false;
+  }
+  double trk = own_val(ownship);
+  TrafficState own = instantaneous_ownship(ownship,trk);
+  Velocity v0 = own.get_v();
+  Velocity v1 = instantaneous_ownship(ownship,trk+Pi/2).get_v();
+  Velocity v2 = instantaneous_ownship(ownship,trk+Pi).get_v();
+  Velocity v3 = instantaneous_ownship(ownship,trk+3*Pi/2).get_v();
+  Velocity co = Velocity::make(v0.Add(v2).Scal(0.5));
+  Vect2 u0 = v0.vect2().Sub(co.vect2());
+  double r = u0.norm();
+  double eps = 1E-9*r;
+  if (Util::almost_equals(r,0) ||
+      v1.vect2().Sub(co.vect2()).Sub(u0.PerpR()).norm() > eps ||
+      v3.vect2().Sub(co.vect2()).Sub(u0.PerpL()).norm() > eps ||
+      std::abs(v1.z-co.z) > eps || std::abs(v3.z-co.z) > eps) {
+    return false;
+  }
+  std::vector<double> trks;
+  if (!det->horizontalCriticalTracks(trks,own.get_s(),co,r,traffic.get_s(),traffic.get_v(),B,T)) {
+    return false;
+  }
+  double trk0 = u0.compassAngle();
+  double step = get_step(parameters);
+  for (int i = 0; i < static_cast<int>(trks.size()); ++i) {
+    steps.push_back(Util::to_2pi(trajdir ? trks[i]-trk0 : trk0-trks[i])/step);
+  }
+  return true;
+}
+
 }
 
@@ -0,0 +1,403 @@
+/*
+ * Copyright (c) 2015-2021 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+/*
+ * DaidalusFileStreamer.cpp
+ *
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include "DaidalusFileStreamer.h"
+#include "DaidalusFileWalker.h"
+#include "Constants.h"
+#include "LatLonAlt.h"
+#include "Vect3.h"
+#include "Util.h"
+#include "format.h"
+#include "string_util.h"
+
+namespace larcfm {
+
+DaidalusFileStreamer::Entry::Entry() : order(0) {}
+
+bool DaidalusFileStreamer::Entry::operator<(const Entry& entry) const {
+  return order < entry.order;
+}
+
+DaidalusFileStreamer::DaidalusFileStreamer(const std::string& filename) : error_("DaidalusFileStreamer") {
+  init(filename);
+}
+
+void DaidalusFileStreamer::resetInputFile(const std::string& filename) {
+  init(filename);
+}
+
+void DaidalusFileStreamer::init(const std::string& filename) {
+  error_ = ErrorLog("DaidalusFileStreamer("+filename+")");
+  header_read_ = false;
+  latlon_ = false;
+  clock_ = false;
+  trkgsvs_ = false;
+  head_.assign(DEFINED_COLUMNS,-1);
+  names_.clear();
+  last_name_ = "";
+  step_.clear();
+  time_ = NaN;
+  index_ = 0;
+  next_time_ = NaN;
+  has_next_ = false;
+  if (in_.is_open()) {
+    in_.close();
+  }
+  in_.clear();
+  in_.open(filename.c_str());
+  if (in_.fail()) {
+    error_.addError("File "+filename+" read protected or not found");
+    input_ = SeparatedInput();
+    return;
+  }
+  input_ = SeparatedInput(&in_);
+  input_.setCaseSensitive(false); // headers & parameters are lower case
+  has_next_ = readEntry(next_,next_time_);
+  readStep();
+}
+
+int DaidalusFileStreamer::altHeadings(const std::string& s1, const std::string& s2, const std::string& s3, const std::string& s4) const {
+  int r = input_.findHeading(s1);
+  if (r < 0 && s2 != "") {
+    r = input_.findHeading(s2);
+  }
+  if (r < 0 && s3 != "") {
+    r = input_.findHeading(s3);
+  }
+  if (r < 0 && s4 != "") {
+    r = input_.findHeading(s4);
+  }
+  return r;
+}
+
+// Process headings of the file. Return false if the file cannot be read.
+bool DaidalusFileStreamer::readHeader() {
+  latlon_ = altHeadings("lat","lon","long","latitude") >= 0;
+  clock_ = altHeadings("clock","","","") >= 0;
+  trkgsvs_ = altHeadings("trk","track","","") >= 0;
+
+  head_[NAME] = altHeadings("name","aircraft","id","");
+  head_[LAT_SX] = altHeadings("sx","lat","latitude","");
+  head_[LON_SY] = altHeadings("sy","lon","long","longitude");
+  head_[ALT_SZ] = altHeadings("sz","alt","altitude","");
+  head_[TRK_VX] = altHeadings("trk","vx","track","");
+  head_[GS_VY] = altHeadings("gs","vy","groundspeed","groundspd");
+  head_[VS_VZ] = altHeadings("vs","vz","verticalspeed","hdot");
+  head_[TM_CLK] = altHeadings("clock","time","tm","st");
+
+  ParameterData& params = input_.getParametersRef();
+  if (params.contains("filetype")) {
+    std::string sval = params.getString("filetype");
+    if (!equalsIgnoreCase(sval,"state") && !equalsIgnoreCase(sval,"history") && !equalsIgnoreCase(sval,"sequence")) {
+      error_.addError("Wrong filetype: "+sval);
+      return false;
+    }
+  }
+
+  // Remaining columns are extra columns
+  for (int i = 0; i < input_.size(); ++i) {
+    std::string hd = input_.getHeading(i);
+    if (hd != "") {
+      int headingindex = input_.findHeading(hd);
+      if (std::find(head_.begin(),head_.end(),headingindex) == head_.end()) {
+        head_.push_back(headingindex);
+      }
+    }
+  }
+
+  header_read_ = true;
+  for (int i = 0; i <= TM_CLK; ++i) {
+    if (head_[i] < 0) {
+      error_.addError("This appears to be an invalid state file (missing header definitions)");
+    }
+  }
+  return true;
+}
+
+// Read next line of the file into entry. Return false at end of file or if the
+// file cannot be read any further.
+bool DaidalusFileStreamer::readEntry(Entry& entry, double& tm) {
+  if (!in_.is_open() || input_.readLine()) {
+    return false;
+  }
+  if (!header_read_ && !readHeader()) {
+    return false;
+  }
+
+  std::string name = input_.getColumnString(head_[NAME]);
+  if (name == "\"" && last_name_ != "") {
+    name = last_name_;
+  } else if (name == "\"" || name == "") {
+    error_.addError("Cannot find first aircraft");
+    return false;
+  } else if (names_.find(name) == names_.end()) {
+    last_name_ = name;
+    int order = names_.size();
+    names_[name] = order;
+  }
+
+  tm = 0.0;
+  if (head_[TM_CLK] >= 0) {
+    try {
+      if (clock_) {
+        tm = Util::parse_time(input_.getColumnString(head_[TM_CLK]));
+      } else {
+        tm = input_.getColumn(head_[TM_CLK],"s");
+      }
+    } catch (std::runtime_error& e) {
+      error_.addError("error parsing time at line "+Fm0(input_.lineNumber()));
+    }
+  }
+
+  if (input_.hasError()) {
+    error_.addError(input_.getMessage());
+    return false;
+  }
+
+  entry.name = name;
+  entry.order = names_[name];
+  // Accuracy parameters of the file only apply while reading a line
+  double h = Constants::get_horizontal_accuracy();
+  double v = Constants::get_vertical_accuracy();
+  double t = Constants::get_time_accuracy();
+  const ParameterData& params = input_.getParametersRef();
+  if (params.contains("horizontalAccuracy")) {
+    Constants::set_horizontal_accuracy(params.getValue("horizontalAccuracy","m"));
+  }
+  if (params.contains("verticalAccuracy")) {
+    Constants::set_vertical_accuracy(params.getValue("verticalAccuracy","m"));
+  }
+  if (params.contains("timeAccuracy")) {
+    Constants::set_time_accuracy(params.getValue("timeAccuracy","s"));
+  }
+  if (latlon_) {
+    entry.pos = Position(LatLonAlt::mk(input_.getColumn(head_[LAT_SX],"deg"),
+        input_.getColumn(head_[LON_SY],"deg"),
+        input_.getColumn(head_[ALT_SZ],"ft")));
+  } else {
+    entry.pos = Position(Vect3(
+        input_.getColumn(head_[LAT_SX],"nmi"),
+        input_.getColumn(head_[LON_SY],"nmi"),
+        input_.getColumn(head_[ALT_SZ],"ft")));
+  }
+  if (trkgsvs_) {
+    entry.vel = Velocity::mkTrkGsVs(
+        input_.getColumn(head_[TRK_VX],"deg"),
+        input_.getColumn(head_[GS_VY],"knot"),
+        input_.getColumn(head_[VS_VZ],"fpm"));
+  } else {
+    entry.vel = Velocity::mkVxyz(
+        input_.getColumn(head_[TRK_VX],"knot"),
+        input_.getColumn(head_[GS_VY],"knot"),
+        input_.getColumn(head_[VS_VZ],"fpm"));
+  }
+  Constants::set_horizontal_accuracy(h);
+  Constants::set_vertical_accuracy(v);
+  Constants::set_time_accuracy(t);
+
+  // Extra columns are converted to parameters as in DaidalusFileWalker
+  entry.extra = ParameterData();
+  for (int i = DEFINED_COLUMNS; i < static_cast<int>(head_.size()); ++i) {
+    int colnum = head_[i];
+    if (input_.columnHasValue(colnum)) {
+      std::string col = input_.getHeading(colnum);
+      std::string units = input_.getUnit(colnum);
+      if (units == "unitless" || units == "unspecified") {
+        entry.extra.set(col,input_.getColumnString(colnum));
+      } else {
+        entry.extra.setInternal(col,input_.getColumn(colnum,NaN,false),units);
+      }
+    }
+  }
+  return true;
+}
+
+// Read all lines of the next time step. The first line of the time step
+// is already in next_, and the first line of the following time step is left in next_.
+void DaidalusFileStreamer::readStep() {
+  step_.clear();
+  if (!has_next_) {
+    time_ = NaN;
+    return;
+  }
+  time_ = next_time_;
+  step_.push_back(next_);
+  Entry entry;
+  double tm;
+  while ((has_next_ = readEntry(entry,tm))) {
+    if (tm == time_) {
+      // A later line of the same aircraft at the same time replaces the earlier one
+      std::vector<Entry>::iterator it = step_.begin();
+      while (it != step_.end() && it->name != entry.name) {
+        ++it;
+      }
+      if (it != step_.end()) {
+        *it = entry;
+      } else {
+        step_.push_back(entry);
+      }
+    } else if (tm > time_) {
+      next_ = entry;
+      next_time_ = tm;
+      break;
+    } else {
+      error_.addError("Time not increasing from "+Fm4(time_)+" to "+Fm4(tm)+" for aircraft "+
+          entry.name+" at line "+Fm0(input_.lineNumber())+", skipping line");
+    }
+  }
+  std::sort(step_.begin(),step_.end());
+}
+
+/**
+ * By default ownship is the first aircraft in the daa file.
+ * This method allows for the selection of a different aircraft as the ownship
+ * If aircraft with given name doesn't exist at a time step, no ownship or traffic
+ * is added to the Daidalus object at that particular time step.
+ */
+void DaidalusFileStreamer::setOwnship(const std::string& name) {
+  ownship_ = name;
+}
+
+/**
+ * Returns the name of the ownship.
+ * An empty string refers to the aircraft that is the first in the daa file
+ */
+const std::string& DaidalusFileStreamer::getOwnship() const {
+  return ownship_;
+}
+
+/**
+ * Reset the ownship value so that the first aircraft in the daa are considered
+ * the ownship.
+ */
+void DaidalusFileStreamer::resetOwnship() {
+  setOwnship("");
+}
+
+/**
+ * By default all aircraft that are not the ownship are considered to be traffic.
+ * This method add a particular aircraft to the list of selected aircraft.
+ * Several aircraft can be selected, but if the list of selected aircraft is non empty,
+ * only the aircraft in the list are considered traffic.
+ */
+void DaidalusFileStreamer::selectTraffic(const std::string& name) {
+  traffic_.push_back(name);
+}
+
+/**
+ * By default all aircraft that are not the ownship are considered to be traffic.
+ * This method add a list of aircraft to the list of selected aircraft.
+ * Several aircraft can be selected, but if the list of selected aircraft is non empty,
+ * only the aircraft in the list are considered traffic.
+ */
+void DaidalusFileStreamer::selectTraffic(const std::vector<std::string>& names) {
+  traffic_.insert(traffic_.end(),names.begin(),names.end());
+}
+
+/**
+ * Returns the list of selected traffic. An empty list means that all aircraft that are
+ * not the ownship are considered traffic.
+ */
+const std::vector<std::string>& DaidalusFileStreamer::getSelectedTraffic() const {
+  return traffic_;
+}
+
+/**
+ * Reset the list of selected aircraft so that all aircraft that are not ownship are
+ * considered traffic.
+ */
+void DaidalusFileStreamer::resetSelectedTraffic() {
+  traffic_.clear();
+}
+
+int DaidalusFileStreamer::getIndex() const {
+  return index_;
+}
+
+double DaidalusFileStreamer::getTime() const {
+  return time_;
+}
+
+bool DaidalusFileStreamer::atBeginning() const {
+  return index_ == 0;
+}
+
+bool DaidalusFileStreamer::atEnd() const {
+  return step_.empty();
+}
+
+void DaidalusFileStreamer::goNext() {
+  if (!atEnd()) {
+    ++index_;
+    readStep();
+  }
+}
+
+bool DaidalusFileStreamer::goToTime(double t) {
+  if (atEnd() || t < getTime()) {
+    return false;
+  }
+  while (has_next_ && next_time_ <= t) {
+    goNext();
+  }
+  return has_next_ || t == getTime();
+}
+
+void DaidalusFileStreamer::readState(Daidalus& daa) {
+  int own = 0; // By default onwship is 0
+  if (ownship_ != "") {
+    own = -1;
+    for (int ac = 0; ac < static_cast<int>(step_.size()); ++ac) {
+      if (step_[ac].name == ownship_) {
+        own = ac;
+        break;
+      }
+    }
+  }
+  if (own >= 0 && own < static_cast<int>(step_.size())) {
+    daa.setOwnshipState(step_[own].name,step_[own].pos,step_[own].vel,getTime());
+    DaidalusFileWalker::readExtraColumns(daa,step_[own].extra,0);
+    for (int ac = 0; ac < static_cast<int>(step_.size()); ++ac) {
+      if (ac == own) {
+        continue;
+      }
+      const std::string& ida = step_[ac].name;
+      if (traffic_.empty() ||
+          std::find(traffic_.begin(),traffic_.end(),ida) != traffic_.end()) {
+        int ac_idx = daa.addTrafficState(ida,step_[ac].pos,step_[ac].vel);
+        DaidalusFileWalker::readExtraColumns(daa,step_[ac].extra,ac_idx);
+      }
+    }
+  }
+  goNext();
+}
+
+// ErrorReporter Interface Methods
+
+bool DaidalusFileStreamer::hasError() const {
+  return error_.hasError();
+}
+
+bool DaidalusFileStreamer::hasMessage() const {
+  return error_.hasMessage();
+}
+
+std::string DaidalusFileStreamer::getMessage() {
+  return error_.getMessage();
+}
+
+std::string DaidalusFileStreamer::getMessageNoClear() const {
+  return error_.getMessageNoClear();
+}
+
+}
@@ -196,7 +196,10 @@ ParameterData DaidalusFileWalker::extraColumnsToParameters(const SequenceReader&
 
 
 void DaidalusFileWalker::readExtraColumns(Daidalus& daa, const SequenceReader& sr, int ac_idx) {
-  ParameterData pcol = extraColumnsToParameters(sr,daa.getCurrentTime(),daa.getAircraftStateAt(ac_idx).getId());
+  readExtraColumns(daa,extraColumnsToParameters(sr,daa.getCurrentTime(),daa.getAircraftStateAt(ac_idx).getId()),ac_idx);
+}
+
+void DaidalusFileWalker::readExtraColumns(Daidalus& daa, const ParameterData& pcol, int ac_idx) {
   if (pcol.size() > 0) {
     daa.setParameterData(pcol);
     if (pcol.contains("alerter")) {
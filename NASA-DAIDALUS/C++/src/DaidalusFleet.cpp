@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) 2015-2021 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+
+#include "DaidalusFleet.h"
+#include "DaidalusThreadPool.h"
+#include "TrafficState.h"
+#include "Horizontal.h"
+#include "Util.h"
+#include <functional>
+
+namespace larcfm {
+
+DaidalusFleet::Aircraft::Aircraft(const std::string& id, const Position& pos, const Velocity& vel, double time, bool ownship) :
+    id(id), pos(pos), vel(vel), time(time), ownship(ownship) {}
+
+DaidalusFleet::Engine::Engine(const Daidalus& config) : daa(config), roster(-1) {}
+
+DaidalusFleet::Summary::Summary() : alert_level(-1), time_to_corrective_volume(PINFINITY) {
+  horizontal_direction_resolution[0] = horizontal_direction_resolution[1] = NaN;
+  horizontal_speed_resolution[0] = horizontal_speed_resolution[1] = NaN;
+  vertical_speed_resolution[0] = vertical_speed_resolution[1] = NaN;
+  altitude_resolution[0] = altitude_resolution[1] = NaN;
+}
+
+DaidalusFleet::DaidalusFleet() : roster_(0), current_time_(0), parallel_(true),
+    direction_resolutions_(false), hs_resolutions_(false), vs_resolutions_(false), alt_resolutions_(false) {
+  config_.clear();
+}
+
+DaidalusFleet::DaidalusFleet(const Daidalus& daa) : config_(daa), roster_(0), current_time_(0), parallel_(true),
+    direction_resolutions_(false), hs_resolutions_(false), vs_resolutions_(false), alt_resolutions_(false) {
+  config_.clear();
+}
+
+void DaidalusFleet::setConfiguration(const Daidalus& daa) {
+  config_ = daa;
+  config_.clear();
+  engines_.clear();
+}
+
+const Daidalus& DaidalusFleet::getConfiguration() const {
+  return config_;
+}
+
+void DaidalusFleet::setParallel(bool flag) {
+  parallel_ = flag;
+}
+
+bool DaidalusFleet::isParallel() const {
+  return parallel_;
+}
+
+void DaidalusFleet::setHorizontalDirectionResolutions(bool flag) {
+  direction_resolutions_ = flag;
+}
+
+bool DaidalusFleet::isEnabledHorizontalDirectionResolutions() const {
+  return direction_resolutions_;
+}
+
+void DaidalusFleet::setHorizontalSpeedResolutions(bool flag) {
+  hs_resolutions_ = flag;
+}
+
+bool DaidalusFleet::isEnabledHorizontalSpeedResolutions() const {
+  return hs_resolutions_;
+}
+
+void DaidalusFleet::setVerticalSpeedResolutions(bool flag) {
+  vs_resolutions_ = flag;
+}
+
+bool DaidalusFleet::isEnabledVerticalSpeedResolutions() const {
+  return vs_resolutions_;
+}
+
+void DaidalusFleet::setAltitudeResolutions(bool flag) {
+  alt_resolutions_ = flag;
+}
+
+bool DaidalusFleet::isEnabledAltitudeResolutions() const {
+  return alt_resolutions_;
+}
+
+int DaidalusFleet::setAircraftState(const std::string& id, const Position& pos, const Velocity& vel, double time, bool ownship) {
+  std::map<std::string,int>::const_iterator it = aircraft_idx_.find(id);
+  if (it != aircraft_idx_.end()) {
+    aircraft_[it->second] = Aircraft(id,pos,vel,time,ownship);
+  } else {
+    aircraft_idx_[id] = aircraft_.size();
+    aircraft_.push_back(Aircraft(id,pos,vel,time,ownship));
+    ++roster_;
+  }
+  return aircraft_.size();
+}
+
+int DaidalusFleet::setAircraftState(const std::string& id, const Position& pos, const Velocity& vel, double time) {
+  return setAircraftState(id,pos,vel,time,true);
+}
+
+bool DaidalusFleet::removeAircraft(const std::string& id) {
+  std::map<std::string,int>::iterator it = aircraft_idx_.find(id);
+  if (it == aircraft_idx_.end()) {
+    return false;
+  }
+  int idx = it->second;
+  aircraft_idx_.erase(it);
+  // Move last aircraft into the removed position
+  int last = aircraft_.size()-1;
+  if (idx != last) {
+    aircraft_[idx] = aircraft_[last];
+    aircraft_idx_[aircraft_[idx].id] = idx;
+  }
+  aircraft_.pop_back();
+  ++roster_;
+  return true;
+}
+
+void DaidalusFleet::clear() {
+  aircraft_.clear();
+  aircraft_idx_.clear();
+  ++roster_;
+}
+
+int DaidalusFleet::numberOfAircraft() const {
+  return aircraft_.size();
+}
+
+bool DaidalusFleet::hasAircraft(const std::string& id) const {
+  return aircraft_idx_.find(id) != aircraft_idx_.end();
+}
+
+bool DaidalusFleet::isOwnship(const std::string& id) const {
+  std::map<std::string,int>::const_iterator it = aircraft_idx_.find(id);
+  return it != aircraft_idx_.end() && aircraft_[it->second].ownship;
+}
+
+// Set state of ownship i and states of all other aircraft, projected to current time, in the Daidalus object
+// of ownship i. If no aircraft has been added or removed since the last time the object was set, its traffic
+// is in the same order as aircraft_, so states are updated in place. Otherwise, the traffic list is rebuilt.
+void DaidalusFleet::update_engine(Engine& engine, int i, const std::vector<Position>& pos) const {
+  Daidalus& daa = engine.daa;
+  int n = aircraft_.size();
+  if (engine.roster == roster_) {
+    daa.updateOwnshipState(aircraft_[i].id,pos[i],aircraft_[i].vel,current_time_);
+    bool updated = daa.lastTrafficIndex() == n-1;
+    for (int j = 0, ac = 1; updated && j < n; ++j) {
+      if (j != i) {
+        updated = daa.updateTrafficState(ac++,pos[j],aircraft_[j].vel,current_time_);
+      }
+    }
+    if (updated) {
+      return;
+    }
+  }
+  daa.setOwnshipState(aircraft_[i].id,pos[i],aircraft_[i].vel,current_time_);
+  for (int j = 0; j < n; ++j) {
+    if (j != i) {
+      daa.addTrafficState(aircraft_[j].id,pos[j],aircraft_[j].vel,current_time_);
+    }
+  }
+  // Aircraft with invalid states are not added, so the traffic list is rebuilt again next time
+  engine.roster = daa.lastTrafficIndex() == n-1 ? roster_ : -1;
+}
+
+// Summarize results of daa, whose ownship and traffic states are already set
+void DaidalusFleet::summarize(Summary& summary, Daidalus& daa) const {
+  summary.alert_level = 0;
+  summary.alerting_ac = "";
+  summary.time_to_corrective_volume = PINFINITY;
+  double alerting_tin = PINFINITY;
+  for (int ac = 1; ac <= daa.lastTrafficIndex(); ++ac) {
+    int alert_level = daa.alertLevel(ac);
+    double tin = daa.timeToCorrectiveVolume(ac);
+    if (alert_level > 0 && (alert_level > summary.alert_level ||
+        (alert_level == summary.alert_level && tin < alerting_tin))) {
+      summary.alert_level = alert_level;
+      summary.alerting_ac = daa.getAircraftStateAt(ac).getId();
+      alerting_tin = tin;
+    }
+    summary.time_to_corrective_volume = Util::min(summary.time_to_corrective_volume,tin);
+  }
+  // Resolutions of other dimensions are left as NaN, so that their bands are not computed
+  for (int d = 0; d <= 1; ++d) {
+    if (direction_resolutions_) {
+      summary.horizontal_direction_resolution[d] = daa.horizontalDirectionResolution(d == 1);
+    }
+    if (hs_resolutions_) {
+      summary.horizontal_speed_resolution[d] = daa.horizontalSpeedResolution(d == 1);
+    }
+    if (vs_resolutions_) {
+      summary.vertical_speed_resolution[d] = daa.verticalSpeedResolution(d == 1);
+    }
+    if (alt_resolutions_) {
+      summary.altitude_resolution[d] = daa.altitudeResolution(d == 1);
+    }
+  }
+}
+
+void DaidalusFleet::compute() {
+  int n = aircraft_.size();
+  for (int i = 0; i < n; ++i) {
+    current_time_ = i == 0 ? aircraft_[i].time : Util::max(current_time_,aircraft_[i].time);
+  }
+  // States are projected to current time once for all ownships
+  std::vector<Position> pos;
+  pos.reserve(n);
+  for (int i = 0; i < n; ++i) {
+    double dt = current_time_-aircraft_[i].time;
+    pos.push_back(dt == 0 ? aircraft_[i].pos : aircraft_[i].pos.linear(aircraft_[i].vel,dt));
+  }
+  // Daidalus objects of aircraft that are no longer ownships are removed. Daidalus objects of new
+  // ownships are created here, so that tasks don't modify engines_.
+  std::map<std::string,Engine>::iterator it = engines_.begin();
+  while (it != engines_.end()) {
+    if (isOwnship(it->first)) {
+      ++it;
+    } else {
+      engines_.erase(it++);
+    }
+  }
+  std::vector<Engine*> engines(n,NULL);
+  for (int i = 0; i < n; ++i) {
+    if (aircraft_[i].ownship) {
+      it = engines_.find(aircraft_[i].id);
+      if (it == engines_.end()) {
+        it = engines_.insert(std::make_pair(aircraft_[i].id,Engine(config_))).first;
+      }
+      engines[i] = &it->second;
+    }
+  }
+  std::vector<Summary> summaries(n);
+  std::vector<std::function<void()> > tasks;
+  for (int i = 0; i < n; ++i) {
+    if (engines[i] != NULL) {
+      tasks.push_back([this,i,&pos,&engines,&summaries]() {
+        update_engine(*engines[i],i,pos);
+        summarize(summaries[i],engines[i]->daa);
+      });
+    }
+  }
+  if (parallel_) {
+    DaidalusThreadPool::shared().run(tasks);
+  } else {
+    for (int k = 0; k < static_cast<int>(tasks.size()); ++k) {
+      tasks[k]();
+    }
+  }
+  computed_idx_ = aircraft_idx_;
+  computed_.clear();
+  computed_.reserve(n);
+  for (int i = 0; i < n; ++i) {
+    computed_.push_back(Aircraft(aircraft_[i].id,pos[i],aircraft_[i].vel,current_time_,aircraft_[i].ownship));
+  }
+  summaries_.swap(summaries);
+}
+
+double DaidalusFleet::getCurrentTime() const {
+  return current_time_;
+}
+
+bool DaidalusFleet::hasSummary(const std::string& id) const {
+  std::map<std::string,int>::const_iterator it = computed_idx_.find(id);
+  return it != computed_idx_.end() && computed_[it->second].ownship;
+}
+
+const DaidalusFleet::Summary& DaidalusFleet::getSummary(const std::string& id) const {
+  static const Summary empty;
+  std::map<std::string,int>::const_iterator it = computed_idx_.find(id);
+  return it != computed_idx_.end() ? summaries_[it->second] : empty;
+}
+
+DaidalusResults DaidalusFleet::getResults(const std::string& id) {
+  std::map<std::string,int>::const_iterator it = computed_idx_.find(id);
+  if (it != computed_idx_.end() && computed_[it->second].ownship) {
+    std::map<std::string,Engine>::iterator engine = engines_.find(id);
+    if (engine != engines_.end()) {
+      return engine->second.daa.snapshot();
+    }
+  }
+  return DaidalusResults();
+}
+
+// Set s and v to the relative position and velocity of id1 with respect to id2, at last computation,
+// in the Euclidean projection centered at id1. Return false if any of the aircraft is not in the last
+// computation.
+bool DaidalusFleet::relative_state(Vect3& s, Vect3& v, const std::string& id1, const std::string& id2) const {
+  std::map<std::string,int>::const_iterator it1 = computed_idx_.find(id1);
+  std::map<std::string,int>::const_iterator it2 = computed_idx_.find(id2);
+  if (it1 == computed_idx_.end() || it2 == computed_idx_.end() || it1->second == it2->second) {
+    return false;
+  }
+  const Aircraft& ac1 = computed_[it1->second];
+  const Aircraft& ac2 = computed_[it2->second];
+  TrafficState own = TrafficState::makeOwnship(ac1.id,ac1.pos,ac1.vel);
+  TrafficState ac = own.makeIntruder(ac2.id,ac2.pos,ac2.vel);
+  if (!ac.isValid()) {
+    return false;
+  }
+  s = own.get_s()-ac.get_s();
+  v = own.get_v()-ac.get_v();
+  return true;
+}
+
+Vect3 DaidalusFleet::relativePosition(const std::string& id1, const std::string& id2) const {
+  Vect3 s, v;
+  return relative_state(s,v,id1,id2) ? s : Vect3::INVALID();
+}
+
+Vect3 DaidalusFleet::relativeVelocity(const std::string& id1, const std::string& id2) const {
+  Vect3 s, v;
+  return relative_state(s,v,id1,id2) ? v : Vect3::INVALID();
+}
+
+double DaidalusFleet::timeToHorizontalClosestPointOfApproach(const std::string& id1, const std::string& id2) const {
+  Vect3 s, v;
+  return relative_state(s,v,id1,id2) ? Util::max(0.0,Horizontal::tcpa(s.vect2(),v.vect2())) : NaN;
+}
+
+double DaidalusFleet::predictedHorizontalMissDistance(const std::string& id1, const std::string& id2) const {
+  Vect3 s, v;
+  return relative_state(s,v,id1,id2) ? Horizontal::hmd(s.vect2(),v.vect2(),config_.getLookaheadTime()) : NaN;
+}
+
+}
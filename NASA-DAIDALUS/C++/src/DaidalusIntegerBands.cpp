@@ -11,9 +11,84 @@
 #include "Util.h"
 #include <vector>
 #include <string>
+#include <algorithm>
 
 namespace larcfm {
 
+DaidalusIntegerBands::DaidalusIntegerBands() : traj_parameters_(NULL), traj_ownship_(NULL), traj_tstep_(0), traj_built_(false) {
+  traj_max_[0] = traj_max_[1] = 0;
+}
+
+DaidalusIntegerBands::DaidalusIntegerBands(const DaidalusIntegerBands& b) :
+    traj_parameters_(NULL), traj_ownship_(NULL), traj_tstep_(0), traj_built_(false) {
+  traj_max_[0] = traj_max_[1] = 0;
+}
+
+DaidalusIntegerBands& DaidalusIntegerBands::operator=(const DaidalusIntegerBands& b) {
+  clear_trajectory_table();
+  return *this;
+}
+
+void DaidalusIntegerBands::tabulate_trajectory(const DaidalusParameters& parameters, const TrafficState& ownship,
+    double tstep, int maxl, int maxr) {
+  clear_trajectory_table();
+  if (tstep <= 0) {
+    return;
+  }
+  traj_parameters_ = &parameters;
+  traj_ownship_ = &ownship;
+  traj_tstep_ = tstep;
+  traj_max_[0] = maxl;
+  traj_max_[1] = maxr;
+}
+
+// Compute the trajectory table, if enabled for ownship and not computed yet
+void DaidalusIntegerBands::build_trajectory_table(const TrafficState& ownship) const {
+  if (&ownship != traj_ownship_ || traj_built_.load(std::memory_order_acquire)) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(traj_mutex_);
+  if (traj_built_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  for (int d = 0; d < 2; ++d) {
+    int n = traj_max_[d]+2;
+    traj_s_[d].reserve(n);
+    traj_v_[d].reserve(n);
+    for (int k = 0; k < n; ++k) {
+      std::pair<Vect3,Velocity> sovot = trajectory(*traj_parameters_,ownship,k*traj_tstep_,d == 1,0,false);
+      traj_s_[d].push_back(sovot.first);
+      traj_v_[d].push_back(sovot.second);
+    }
+  }
+  traj_built_.store(true,std::memory_order_release);
+}
+
+void DaidalusIntegerBands::clear_trajectory_table() {
+  traj_parameters_ = NULL;
+  traj_ownship_ = NULL;
+  traj_tstep_ = 0;
+  traj_built_.store(false);
+  for (int d = 0; d < 2; ++d) {
+    traj_s_[d].clear();
+    traj_v_[d].clear();
+  }
+}
+
+std::pair<Vect3,Velocity> DaidalusIntegerBands::ownship_trajectory(const DaidalusParameters& parameters, const TrafficState& ownship,
+    double time, bool dir, int target_step, bool instantaneous) const {
+  if (&ownship == traj_ownship_ && target_step == 0 && !instantaneous && time >= 0 &&
+      traj_built_.load(std::memory_order_acquire)) {
+    int d = dir ? 1 : 0;
+    int k = static_cast<int>(time/traj_tstep_+0.5);
+    // Only times that are exactly a multiple of the time step are taken from the table
+    if (k < static_cast<int>(traj_s_[d].size()) && k*traj_tstep_ == time) {
+      return std::pair<Vect3,Velocity>(traj_s_[d][k],traj_v_[d][k]);
+    }
+  }
+  return trajectory(parameters,ownship,time,dir,target_step,instantaneous);
+}
+
 /**
  * In PVS: int_bands@CD_future_traj
  */
@@ -21,7 +96,7 @@ bool DaidalusIntegerBands::CD_future_traj(const Detection3D* det, double B, doub
     const DaidalusParameters& parameters,  const TrafficState& ownship, const TrafficState& traffic, int target_step, bool instantaneous) const {
   T = Util::min(parameters.getLookaheadTime(),T);
   if (tsk > T || B > T) return false;
-  std::pair<Vect3,Velocity> sovot = trajectory(parameters,ownship,tsk,trajdir,target_step,instantaneous);
+  std::pair<Vect3,Velocity> sovot = ownship_trajectory(parameters,ownship,tsk,trajdir,target_step,instantaneous);
   Vect3 sot = sovot.first;
   Velocity vot = sovot.second;
   Vect3 sat = tsk == 0.0 ? sot : vot.ScalAdd(-tsk,sot);
@@ -53,7 +128,7 @@ bool DaidalusIntegerBands::LOS_at(const Detection3D* det, bool trajdir, double t
   if (tsk >= parameters.getLookaheadTime()) {
       return false;
   }
-  std::pair<Vect3,Velocity> sovot = trajectory(parameters,ownship,tsk,trajdir,target_step,instantaneous);
+  std::pair<Vect3,Velocity> sovot = ownship_trajectory(parameters,ownship,tsk,trajdir,target_step,instantaneous);
   Vect3 sot = sovot.first;
   Velocity vot = sovot.second;
   Vect3 sat = vot.ScalAdd(-tsk,sot);
@@ -109,7 +184,8 @@ int DaidalusIntegerBands::kinematic_bands_search_index(const Detection3D* confli
 }
 
 // In PVS: int_bands@traj_conflict_only_band, int_bands@nat_bands, and int_bands@nat_bands_rec
-
+// Kinematic steps are checked one by one. When a trajectory grazes the conflict volume, a red band may contain a
+// single step, and detectors don't provide a lower bound on the width of their volumes that would allow skipping steps.
 void DaidalusIntegerBands::kinematic_traj_conflict_only_bands(std::vector<Integerval>& l,
     const Detection3D* conflict_det, const Detection3D* recovery_det, double tstep, double B, double T,
     bool trajdir, int max,const DaidalusParameters& parameters,  const TrafficState& ownship, const TrafficState& traffic) const {
@@ -165,8 +241,8 @@ int DaidalusIntegerBands::first_kinematic_green(const Detection3D* conflict_det,
 }
 
 Vect3 DaidalusIntegerBands::kinematic_linvel(const DaidalusParameters& parameters, const TrafficState& ownship, double tstep, bool trajdir, int k) const {
-  Vect3 s1 = trajectory(parameters,ownship,(k+1)*tstep,trajdir,0,false).first;
-  Vect3 s0 = trajectory(parameters,ownship,k*tstep,trajdir,0,false).first;
+  Vect3 s1 = ownship_trajectory(parameters,ownship,(k+1)*tstep,trajdir,0,false).first;
+  Vect3 s0 = ownship_trajectory(parameters,ownship,k*tstep,trajdir,0,false).first;
   return s1.Sub(s0).Scal(1/tstep);
 }
 
@@ -176,7 +252,7 @@ bool DaidalusIntegerBands::kinematic_repulsive_at(double tstep, bool trajdir, in
   if (k==0) {
     return true;
   }
-  std::pair<Vect3,Velocity> sovo = trajectory(parameters,ownship,0,trajdir,0,false);
+  std::pair<Vect3,Velocity> sovo = ownship_trajectory(parameters,ownship,0,trajdir,0,false);
   Vect2 so = sovo.first.vect2();
   Vect2 vo = sovo.second.vect2();
   Vect2 si = traffic.get_s().vect2();
@@ -186,7 +262,7 @@ bool DaidalusIntegerBands::kinematic_repulsive_at(double tstep, bool trajdir, in
     rep = CriteriaCore::horizontal_new_repulsive_criterion(so.Sub(si), vo, vi, kinematic_linvel(parameters,ownship,tstep,trajdir,0).vect2(), epsh);
   }
   if (rep) {
-    std::pair<Vect3,Velocity> sovot = trajectory(parameters,ownship,k*tstep,trajdir,0,false);
+    std::pair<Vect3,Velocity> sovot = ownship_trajectory(parameters,ownship,k*tstep,trajdir,0,false);
     Vect2 sot = sovot.first.vect2();
     Vect2 vot = sovot.second.vect2();
     Vect2 sit = vi.ScalAdd(k*tstep,si);
@@ -216,7 +292,7 @@ bool DaidalusIntegerBands::kinematic_vert_repul_at(double tstep, bool trajdir, i
   if (k==0) {
     return true;
   }
-  std::pair<Vect3,Velocity> sovo = trajectory(parameters,ownship,0,trajdir,0,false);
+  std::pair<Vect3,Velocity> sovo = ownship_trajectory(parameters,ownship,0,trajdir,0,false);
   Vect3 so = sovo.first;
   Vect3 vo = sovo.second;
   Vect3 si = traffic.get_s();
@@ -226,7 +302,7 @@ bool DaidalusIntegerBands::kinematic_vert_repul_at(double tstep, bool trajdir, i
     rep = CriteriaCore::vertical_new_repulsive_criterion(so.Sub(si),vo,vi,kinematic_linvel(parameters,ownship,tstep,trajdir,0),epsv);
   }
   if (rep) {
-    std::pair<Vect3,Velocity> sovot = trajectory(parameters,ownship,k*tstep,trajdir,0,false);
+    std::pair<Vect3,Velocity> sovot = ownship_trajectory(parameters,ownship,k*tstep,trajdir,0,false);
     Vect3 sot = sovot.first;
     Vect3 vot = sovot.second;
     Vect3 sit = vi.ScalAdd(k*tstep,si);
@@ -279,20 +355,34 @@ int DaidalusIntegerBands::first_instantaneous_green(const Detection3D* conflict_
     double B, double T,
     bool trajdir, int max,const DaidalusParameters& parameters,  const TrafficState& ownship, const TrafficState& traffic,
     int epsh, int epsv) const {
+  std::vector<bool> green;
+  bool critical = instantaneous_green_steps(green,conflict_det,recovery_det,B,T,trajdir,max,parameters,ownship,traffic,epsh,epsv);
+  int first = 0; // When critical is false, green[k] is the status of step first+k
   for (int k = 0; k <= max; ++k) {
-    if (no_instantaneous_conflict(conflict_det,recovery_det,B,T,trajdir,parameters,ownship,traffic,epsh,epsv,k)) {
+    if (!critical && k-first >= static_cast<int>(green.size())) {
+      first = k;
+      instantaneous_no_conflict_steps(green,conflict_det,recovery_det,B,T,trajdir,k,Util::min(k+INSTANTANEOUS_BATCH-1,max),
+          parameters,ownship,traffic,epsh,epsv);
+    }
+    if (green[k-first]) {
       return k;
     }
   }
   return -1;
 }
 
-//In PVS: inst_bands@conflict_free_track_step, inst_bands@conflict_free_gs_step, inst_bands@conflict_free_vs_step
-bool DaidalusIntegerBands::no_instantaneous_conflict(const Detection3D* conflict_det, const Detection3D* recovery_det, double B, double T,
-    bool trajdir,const DaidalusParameters& parameters,  const TrafficState& ownship, const TrafficState& traffic,
+bool DaidalusIntegerBands::instantaneous_critical_steps(std::vector<double>& steps, const Detection3D* det, double B, double T,
+    bool trajdir, const DaidalusParameters& parameters, const TrafficState& ownship, const TrafficState& traffic) const {
+  return false;
+}
+
+bool DaidalusIntegerBands::instantaneous_repulsive(bool trajdir,const DaidalusParameters& parameters,  const TrafficState& ownship, const TrafficState& traffic,
     int epsh, int epsv, int target_step) const {
   bool usehcrit = epsh != 0;
   bool usevcrit = epsv != 0;
+  if (!usehcrit && !usevcrit) {
+    return true;
+  }
   std::pair<Vect3,Velocity> nsovo = trajectory(parameters,ownship,0,trajdir,target_step,true);
   Vect3 so = ownship.get_s();
   Velocity vo = ownship.get_v();
@@ -302,24 +392,125 @@ bool DaidalusIntegerBands::no_instantaneous_conflict(const Detection3D* conflict
   Vect3 s = so.Sub(si);
   return
       (!usehcrit || CriteriaCore::horizontal_new_repulsive_criterion(s.vect2(),vo.vect2(),vi.vect2(),nvo.vect2(),epsh)) &&
-      (!usevcrit || CriteriaCore::vertical_new_repulsive_criterion(s,vo,vi,nvo,epsv)) &&
+      (!usevcrit || CriteriaCore::vertical_new_repulsive_criterion(s,vo,vi,nvo,epsv));
+}
+
+//In PVS: inst_bands@conflict_free_track_step, inst_bands@conflict_free_gs_step, inst_bands@conflict_free_vs_step
+bool DaidalusIntegerBands::no_instantaneous_conflict(const Detection3D* conflict_det, const Detection3D* recovery_det, double B, double T,
+    bool trajdir,const DaidalusParameters& parameters,  const TrafficState& ownship, const TrafficState& traffic,
+    int epsh, int epsv, int target_step) const {
+  return instantaneous_repulsive(trajdir,parameters,ownship,traffic,epsh,epsv,target_step) &&
       no_CD_future_traj(conflict_det,recovery_det,B,T,trajdir,0.0,parameters,ownship,traffic,target_step,true);
 }
 
+void DaidalusIntegerBands::instantaneous_no_CD_steps(std::vector<bool>& free, const Detection3D* det, double B, double T,
+    const DaidalusParameters& parameters, const std::vector<TrafficState>& owns, const TrafficState& traffic) const {
+  // Same as CD_future_traj at time 0 and Detection3D::conflictWithTrafficState
+  T = Util::min(parameters.getLookaheadTime(),T);
+  if (0 > T || B > T) return;
+  B = Util::max(B,0.0);
+  bool at_B = Util::almost_equals(B,T);
+  std::vector<ConflictData> dets;
+  det->conflictDetectionWithTrafficStates(dets,owns,traffic,B,at_B ? B+1 : T);
+  for (int k = 0; k < static_cast<int>(dets.size()); ++k) {
+    if (dets[k].conflict() && (!at_B || Util::almost_equals(dets[k].getTimeIn(),B))) {
+      free[k] = false;
+    }
+  }
+}
+
+void DaidalusIntegerBands::instantaneous_no_conflict_steps(std::vector<bool>& free, const Detection3D* conflict_det, const Detection3D* recovery_det,
+    double B, double T,
+    bool trajdir, int min, int max,const DaidalusParameters& parameters,  const TrafficState& ownship, const TrafficState& traffic,
+    int epsh, int epsv) const {
+  free.assign(Util::max(0,max-min+1),true);
+  std::vector<TrafficState> owns;
+  owns.reserve(free.size());
+  for (int k = min; k <= max; ++k) {
+    // Same ownship state as in CD_future_traj at time 0
+    std::pair<Vect3,Velocity> sovot = ownship_trajectory(parameters,ownship,0.0,trajdir,k,true);
+    TrafficState own = ownship;
+    own.setPosition(Position(sovot.first));
+    own.setAirVelocity(sovot.second);
+    if (!owns.empty() && !(own.get_s() == owns[0].get_s())) {
+      // Maneuvers that change the ownship position, e.g., altitude, are checked one step at a time
+      for (int j = min; j <= max; ++j) {
+        free[j-min] = no_instantaneous_conflict(conflict_det,recovery_det,B,T,trajdir,parameters,ownship,traffic,epsh,epsv,j);
+      }
+      return;
+    }
+    owns.push_back(own);
+  }
+  if (owns.empty()) {
+    return;
+  }
+  instantaneous_no_CD_steps(free,conflict_det,B,T,parameters,owns,traffic);
+  if (recovery_det != NULL) {
+    instantaneous_no_CD_steps(free,recovery_det,0,B,parameters,owns,traffic);
+  }
+  for (int k = min; k <= max; ++k) {
+    if (free[k-min]) {
+      free[k-min] = instantaneous_repulsive(trajdir,parameters,ownship,traffic,epsh,epsv,k);
+    }
+  }
+}
+
+bool DaidalusIntegerBands::instantaneous_green_steps(std::vector<bool>& green, const Detection3D* conflict_det, const Detection3D* recovery_det,
+    double B, double T,
+    bool trajdir, int max,const DaidalusParameters& parameters,  const TrafficState& ownship, const TrafficState& traffic,
+    int epsh, int epsv) const {
+  std::vector<double> steps;
+  if (!instantaneous_critical_steps(steps,conflict_det,B,T,trajdir,parameters,ownship,traffic) ||
+      (recovery_det != NULL && !instantaneous_critical_steps(steps,recovery_det,0,B,trajdir,parameters,ownship,traffic))) {
+    return false;
+  }
+  std::sort(steps.begin(),steps.end());
+  // Steps closer than near to a critical step are checked one by one. Since the conflict status doesn't change
+  // between consecutive critical steps, it's checked once for the remaining steps between them.
+  const double near = 0.25;
+  green.assign(max+1,false);
+  int i = 0; // Index of first critical step that is not before the current step
+  int cell = -1; // Index of the critical step that bounds the last checked group of steps
+  bool cell_free = false;
+  for (int k = 0; k <= max; ++k) {
+    while (i < static_cast<int>(steps.size()) && steps[i] < k-near) {
+      ++i;
+    }
+    bool free;
+    if (i < static_cast<int>(steps.size()) && steps[i] <= k+near) {
+      free = no_CD_future_traj(conflict_det,recovery_det,B,T,trajdir,0.0,parameters,ownship,traffic,k,true);
+      cell = -1;
+    } else if (cell == i) {
+      free = cell_free;
+    } else {
+      free = no_CD_future_traj(conflict_det,recovery_det,B,T,trajdir,0.0,parameters,ownship,traffic,k,true);
+      cell = i;
+      cell_free = free;
+    }
+    green[k] = free && instantaneous_repulsive(trajdir,parameters,ownship,traffic,epsh,epsv,k);
+  }
+  return true;
+}
+
 //In PVS: int_bands@nat_bands, int_bands@nat_bands_rec
 void DaidalusIntegerBands::instantaneous_bands(std::vector<Integerval>& l,
     const Detection3D* conflict_det, const Detection3D* recovery_det, double B, double T,
     bool trajdir, int max,const DaidalusParameters& parameters,  const TrafficState& ownship, const TrafficState& traffic,
     int epsh, int epsv) const {
+  std::vector<bool> green;
+  if (!instantaneous_green_steps(green,conflict_det,recovery_det,B,T,trajdir,max,parameters,ownship,traffic,epsh,epsv)) {
+    instantaneous_no_conflict_steps(green,conflict_det,recovery_det,B,T,trajdir,0,max,parameters,ownship,traffic,epsh,epsv);
+  }
   int d = -1; // Set to the first index with no conflict
   for (int k = 0; k <= max; ++k) {
-    if (d >=0 && no_instantaneous_conflict(conflict_det,recovery_det,B,T,trajdir,parameters,ownship,traffic,epsh,epsv,k)) {
+    bool free = green[k];
+    if (d >=0 && free) {
       continue;
     } else if (d >=0) {
       Integerval iv = Integerval(d,k-1);
       l.push_back(iv);
       d = -1;
-    } else if (no_instantaneous_conflict(conflict_det,recovery_det,B,T,trajdir,parameters,ownship,traffic,epsh,epsv,k)) {
+    } else if (free) {
       d = k;
     }
   }
@@ -333,8 +524,16 @@ bool DaidalusIntegerBands::instantaneous_red_band_exist(const Detection3D* confl
     double B, double T,
     bool trajdir, int max,const DaidalusParameters& parameters,  const TrafficState& ownship, const TrafficState& traffic,
     int epsh, int epsv) const {
+  std::vector<bool> green;
+  bool critical = instantaneous_green_steps(green,conflict_det,recovery_det,B,T,trajdir,max,parameters,ownship,traffic,epsh,epsv);
+  int first = 0; // When critical is false, green[k] is the status of step first+k
   for (int k = 0; k <= max; ++k) {
-    if (!no_instantaneous_conflict(conflict_det,recovery_det,B,T,trajdir,parameters,ownship,traffic,epsh,epsv,k)) {
+    if (!critical && k-first >= static_cast<int>(green.size())) {
+      first = k;
+      instantaneous_no_conflict_steps(green,conflict_det,recovery_det,B,T,trajdir,k,Util::min(k+INSTANTANEOUS_BATCH-1,max),
+          parameters,ownship,traffic,epsh,epsv);
+    }
+    if (!green[k-first]) {
       return true;
     }
   }
@@ -378,6 +577,7 @@ void DaidalusIntegerBands::kinematic_bands_combine(std::vector<Integerval>& l, c
     double B, double T,
     int maxl, int maxr,const DaidalusParameters& parameters,  const TrafficState& ownship, const TrafficState& traffic,
     int epsh, int epsv) const {
+  build_trajectory_table(ownship);
   kinematic_bands(l,conflict_det,recovery_det,tstep,B,T,false,maxl,parameters,ownship,traffic,epsh,epsv);
   std::vector<Integerval> r;
   kinematic_bands(r,conflict_det,recovery_det,tstep,B,T,true,maxr,parameters,ownship,traffic,epsh,epsv);
@@ -401,6 +601,7 @@ bool DaidalusIntegerBands::all_kinematic_red(const Detection3D* conflict_det, co
     double B, double T,
     int maxl, int maxr,const DaidalusParameters& parameters,  const TrafficState& ownship, const TrafficState& traffic,
     int epsh, int epsv, int dir) const {
+  build_trajectory_table(ownship);
   bool leftans = dir > 0 || first_kinematic_green(conflict_det,recovery_det,tstep,B,T,false,maxl,parameters,ownship,traffic,epsh,epsv) < 0;
   bool rightans = dir < 0 || first_kinematic_green(conflict_det,recovery_det,tstep,B,T,true,maxr,parameters,ownship,traffic,epsh,epsv) < 0;
   return leftans && rightans;
@@ -419,6 +620,7 @@ bool DaidalusIntegerBands::any_kinematic_red(const Detection3D* conflict_det, co
     double B, double T,
     int maxl, int maxr,const DaidalusParameters& parameters,  const TrafficState& ownship, const TrafficState& traffic,
     int epsh, int epsv, int dir) const {
+  build_trajectory_table(ownship);
   bool leftred = dir <= 0 && kinematic_red_band_exist(conflict_det,recovery_det,tstep,B,T,false,maxl,parameters,ownship,traffic,epsh,epsv);
   bool rightred = dir >= 0 && kinematic_red_band_exist(conflict_det,recovery_det,tstep,B,T,true,maxr,parameters,ownship,traffic,epsh,epsv);
   return leftred || rightred;
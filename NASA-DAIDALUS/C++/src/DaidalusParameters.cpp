@@ -18,6 +18,10 @@
 #include "WCV_TAUMOD_SUM.h"
 #include <vector>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <sys/types.h>
+#include <sys/stat.h>
 
 namespace larcfm {
 
@@ -34,7 +38,7 @@ void DaidalusParameters::init() {
 }
 
 /* NOTE: By default, no alert levels are configured */
-DaidalusParameters::DaidalusParameters() : error("DaidalusParameters") {
+DaidalusParameters::DaidalusParameters() : alerters_(new std::vector<Alerter>()), error("DaidalusParameters") {
 
   // Bands Parameters
   lookahead_time_ = 180.0; // [s]
@@ -234,20 +238,20 @@ const DaidalusParameters::aliasestype& DaidalusParameters::getAliases() {
 DaidalusParameters::~DaidalusParameters() {}
 
 int DaidalusParameters::numberOfAlerters() const {
-  return alerters_.size();
+  return alerters_->size();
 }
 
 const Alerter& DaidalusParameters::getAlerterAt(int i) const {
-  if (1 <= i && i <= static_cast<int>(alerters_.size())) {
-    return alerters_[i-1];
+  if (1 <= i && i <= static_cast<int>(alerters_->size())) {
+    return (*alerters_)[i-1];
   } else {
     return Alerter::INVALID();
   }
 }
 
 int DaidalusParameters::getAlerterIndex(const std::string& id) const {
-  for (int i=0; i < static_cast<int>(alerters_.size()); ++i) {
-    if (equals(id, alerters_[i].getId())) {
+  for (int i=0; i < static_cast<int>(alerters_->size()); ++i) {
+    if (equals(id, (*alerters_)[i].getId())) {
       return i+1;
     }
   }
@@ -255,7 +259,11 @@ int DaidalusParameters::getAlerterIndex(const std::string& id) const {
 }
 
 void DaidalusParameters::clearAlerters() {
-  alerters_.clear();
+  if (alerters_.use_count() > 1) {
+    alerters_.reset(new std::vector<Alerter>());
+  } else {
+    alerters_->clear();
+  }
 }
 
 /**
@@ -264,13 +272,14 @@ void DaidalusParameters::clearAlerters() {
  */
 int DaidalusParameters::addAlerter(const Alerter& alerter) {
   int i = getAlerterIndex(alerter.getId());
+  std::vector<Alerter>& alerters = mutable_alerters();
   if (i == 0) {
-    alerters_.push_back(alerter);
-    i = alerters_.size();
+    alerters.push_back(alerter);
+    i = alerters.size();
   } else {
-    alerters_[i-1] = alerter;
+    alerters[i-1] = alerter;
   }
-  set_alerter_with_SUM_parameters(alerters_[i-1]);
+  set_alerter_with_SUM_parameters(alerters[i-1]);
   return i;
 }
 
@@ -290,9 +299,17 @@ void DaidalusParameters::set_alerter_with_SUM_parameters(Alerter& alerter) {
  *  user to initialize SUM parameters, which may be specified globally.
  */
 void DaidalusParameters::set_alerters_with_SUM_parameters() {
-  for (int i=0; i < static_cast<int>(alerters_.size()); ++i) {
-    set_alerter_with_SUM_parameters(alerters_[i]);
+  std::vector<Alerter>& alerters = mutable_alerters();
+  for (int i=0; i < static_cast<int>(alerters.size()); ++i) {
+    set_alerter_with_SUM_parameters(alerters[i]);
+  }
+}
+
+std::vector<Alerter>& DaidalusParameters::mutable_alerters() {
+  if (alerters_.use_count() > 1) {
+    alerters_.reset(new std::vector<Alerter>(*alerters_));
   }
+  return *alerters_;
 }
 
 double DaidalusParameters::getLookaheadTime() const {
@@ -1824,9 +1841,8 @@ bool DaidalusParameters::setCorrectiveRegion(BandsRegion::Region val) {
  * for this alerter.
  */
 int DaidalusParameters::correctiveAlertLevel(int alerter_idx) {
-  if (1 <= alerter_idx && alerter_idx <= static_cast<int>(alerters_.size())) {
-    Alerter alerter = alerters_[alerter_idx-1];
-    return alerter.alertLevelForRegion(corrective_region_);
+  if (1 <= alerter_idx && alerter_idx <= static_cast<int>(alerters_->size())) {
+    return (*alerters_)[alerter_idx-1].alertLevelForRegion(corrective_region_);
   } else {
     error.addError("correctiveAlertLevel: alerter_idx ("+Fmi(alerter_idx)+") is out of range");
     return -1;
@@ -1838,8 +1854,8 @@ int DaidalusParameters::correctiveAlertLevel(int alerter_idx) {
  */
 int DaidalusParameters::maxNumberOfAlertLevels() const {
   int maxalert_level = 0;
-  for (int alerter_idx=1; alerter_idx <= static_cast<int>(alerters_.size()); ++alerter_idx) {
-    maxalert_level = std::max(maxalert_level,alerters_[alerter_idx-1].mostSevereAlertLevel());
+  for (int alerter_idx=1; alerter_idx <= static_cast<int>(alerters_->size()); ++alerter_idx) {
+    maxalert_level = std::max(maxalert_level,(*alerters_)[alerter_idx-1].mostSevereAlertLevel());
   }
   return maxalert_level;
 }
@@ -1891,6 +1907,79 @@ bool DaidalusParameters::loadFromFile(const std::string& file) {
 }
 
 
+// Parameters loaded by loadSharedFromFile
+class SharedParameters {
+public:
+  time_t mtime; // Modification time of the file when it was parsed
+  bool ok;
+  ParameterData data; // Parameters in the file
+  bool alerters; // True if the file defines a list of alerters
+  DaidalusParameters parameters; // Default parameters updated with data, which own the shared alerters
+  SharedParameters() : mtime(-1), ok(false), alerters(false) {}
+};
+
+bool DaidalusParameters::same_global_SUM_parameters(const DaidalusParameters& p) const {
+  return h_pos_z_score_ == p.h_pos_z_score_ &&
+      h_vel_z_score_min_ == p.h_vel_z_score_min_ &&
+      h_vel_z_score_max_ == p.h_vel_z_score_max_ &&
+      h_vel_z_distance_ == p.h_vel_z_distance_ &&
+      getUnitsOf("h_vel_z_distance") == p.getUnitsOf("h_vel_z_distance") &&
+      v_pos_z_score_ == p.v_pos_z_score_ &&
+      v_vel_z_score_ == p.v_vel_z_score_;
+}
+
+bool DaidalusParameters::loadSharedFromFile(const std::string& file) {
+  static std::mutex mutex;
+  static std::map<std::string,SharedParameters> cache;
+  struct stat info;
+  if (stat(file.c_str(),&info) != 0) {
+    return loadFromFile(file);
+  }
+  ParameterData data;
+  DaidalusParameters shared_parameters;
+  bool shared_alerters;
+  bool ok;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    SharedParameters& shared = cache[file];
+    if (shared.mtime != info.st_mtime) {
+      StateReader reader;
+      reader.open(file);
+      shared.data = ParameterData();
+      reader.updateParameterData(shared.data);
+      shared.ok = !reader.hasError();
+      // Alerters of DAIDALUS v1 files depend on other parameters, so they are not shared
+      shared.alerters = contains(shared.data,"alerters") &&
+          (contains(shared.data,"corrective_region") || !contains(shared.data,"conflict_level"));
+      shared.parameters = DaidalusParameters();
+      shared.parameters.setParameters(shared.data);
+      shared.mtime = info.st_mtime;
+    }
+    data = shared.data;
+    ok = shared.ok;
+    shared_alerters = shared.alerters;
+    if (shared_alerters) {
+      // The copy shares the alerters of the cache
+      shared_parameters = shared.parameters;
+    }
+  }
+  if (!shared_alerters) {
+    setParameters(data);
+    return ok;
+  }
+  // File parameters are applied on top of the current ones, except for the alerters, which are
+  // taken from the cache instead of being parsed again
+  data.remove("alerters");
+  clearAlerters();
+  setParameters(data);
+  alerters_ = shared_parameters.alerters_;
+  if (!same_global_SUM_parameters(shared_parameters)) {
+    // Current parameters override global SUM parameters of the file, so alerters are copied
+    set_alerters_with_SUM_parameters();
+  }
+  return ok;
+}
+
 bool DaidalusParameters::saveToFile(const std::string& file) {
   std::ofstream out;
   out.open(file.c_str());
@@ -1985,7 +2074,7 @@ std::string DaidalusParameters::toPVS() const {
   s+="dta_alerter := "+Fmi(dta_alerter_)+", ";
   s+="ownship_centric_alerting := "+Fmb(ownship_centric_alerting_)+", ";
   s+="corrective_region := "+BandsRegion::to_string(corrective_region_)+", ";
-  s+="alerters := "+Alerter::listToPVS(alerters_);
+  s+="alerters := "+Alerter::listToPVS(*alerters_);
   s+="#)";
   return s;
 }
@@ -2003,11 +2092,11 @@ ParameterData DaidalusParameters::getParameters() const {
 void DaidalusParameters::writeAlerterList(ParameterData& p) const {
   std::vector<std::string> names;
   std::vector<Alerter>::const_iterator alerter_ptr;
-  for (alerter_ptr = alerters_.begin(); alerter_ptr != alerters_.end(); ++alerter_ptr) {
+  for (alerter_ptr = alerters_->begin(); alerter_ptr != alerters_->end(); ++alerter_ptr) {
     names.push_back(alerter_ptr->getId());
   }
   p.set("alerters",names);
-  for (alerter_ptr = alerters_.begin(); alerter_ptr != alerters_.end(); ++alerter_ptr) {
+  for (alerter_ptr = alerters_->begin(); alerter_ptr != alerters_->end(); ++alerter_ptr) {
     p.copy(alerter_ptr->getParameters().copyWithPrefix(alerter_ptr->getId()+"_"),true);
   }
 }
@@ -2194,7 +2283,8 @@ std::vector<std::string> DaidalusParameters::getListString(const ParameterData&
 }
 
 void DaidalusParameters::readAlerterList(const std::vector<std::string>& alerter_list, const ParameterData& params) {
-  alerters_.clear();
+  clearAlerters();
+  std::vector<Alerter>& alerters = mutable_alerters();
   for (int i = 0; i < static_cast<int>(alerter_list.size()); i++) {
     std::string id = alerter_list[i];
     ParameterData aPd = params.extractPrefix(id+"_");
@@ -2202,7 +2292,7 @@ void DaidalusParameters::readAlerterList(const std::vector<std::string>& alerter
     if (aPd.size() > 0) {
       alerter.setParameters(aPd);
     }
-    alerters_.push_back(alerter);
+    alerters.push_back(alerter);
   }
 }
 
@@ -2514,8 +2604,8 @@ bool DaidalusParameters::setParameterData(const ParameterData& p) {
     Alerter alerter;
     alerter.setParameters(p);
     if (alerter.isValid()) {
-      alerters_.clear();
-      alerters_.push_back(alerter);
+      clearAlerters();
+      mutable_alerters().push_back(alerter);
       int conflict_level=getInt(p,"conflict_level");
       if (1 <= conflict_level && conflict_level <= alerter.mostSevereAlertLevel()) {
         setCorrectiveRegion(alerter.getLevel(conflict_level).getRegion());
@@ -19,10 +19,13 @@
 #include "DaidalusCore.h"
 #include "DaidalusParameters.h"
 #include "RecoveryInformation.h"
+#include "DaidalusThreadPool.h"
 
 #include <cmath>
 #include <vector>
 #include <string>
+#include <atomic>
+#include <functional>
 
 #include "ColorValue.h"
 #include "TrafficState.h"
@@ -34,6 +37,7 @@ DaidalusRealBands::DaidalusRealBands(double mod) {
   mod_ = std::abs(mod);
   min_rel_ = 0;
   max_rel_ = 0;
+  parallel_ = false;
 
   bands_hysteresis_.setMod(mod_);
 
@@ -51,6 +55,7 @@ DaidalusRealBands::DaidalusRealBands(const DaidalusRealBands& b) {
   mod_ = b.mod_;
   min_rel_ = b.min_rel_;
   max_rel_ = b.max_rel_;
+  parallel_ = b.parallel_;
 
   bands_hysteresis_.setMod(mod_);
 
@@ -106,6 +111,24 @@ void DaidalusRealBands::set_min_max_rel(double min_rel, double max_rel) {
   // This method doesn't stale data. Use with care.
 }
 
+/**
+ * Enable/disable parallel computation of none bands of different aircraft.
+ */
+void DaidalusRealBands::set_parallel(bool flag) {
+  parallel_ = flag;
+}
+
+/**
+ * Return true if none bands of different aircraft are computed in parallel.
+ */
+bool DaidalusRealBands::is_parallel() const {
+  return parallel_;
+}
+
+bool DaidalusRealBands::shared_trajectory(const DaidalusParameters& parameters) const {
+  return !instantaneous_bands(parameters);
+}
+
 bool DaidalusRealBands::set_input(const DaidalusParameters& parameters, const TrafficState& ownship, int dta_status) {
   if (checked_ < 0) {
     checked_ = 0;
@@ -245,6 +268,10 @@ bool DaidalusRealBands::isFresh() const {
 void DaidalusRealBands::refresh(DaidalusCore& core) {
   if (outdated_) {
     if (set_input(core.parameters,core.ownship,core.DTAStatus())) {
+      if (shared_trajectory(core.parameters)) {
+        tabulate_trajectory(core.parameters,core.ownship,time_step(core.parameters,core.ownship),
+            maxdown(core.parameters,core.ownship),maxup(core.parameters,core.ownship));
+      }
       for (int conflict_region=0; conflict_region < BandsRegion::NUMBER_OF_CONFLICT_BANDS; ++conflict_region) {
         acs_bands_[conflict_region] = core.acs_conflict_bands(conflict_region);
         if (core.bands_for(conflict_region)) {
@@ -253,6 +280,7 @@ void DaidalusRealBands::refresh(DaidalusCore& core) {
         }
       }
       compute(core);
+      clear_trajectory_table();
     }
     outdated_ = false;
   }
@@ -271,10 +299,11 @@ void DaidalusRealBands::force_compute(DaidalusCore& core) {
  * Put in acs_peripheral_bands_ the list of aircraft predicted to have a peripheral band for the given region.
  */
 void DaidalusRealBands::peripheral_aircraft(DaidalusCore& core, int conflict_region) {
+  double max_own_speed = core.max_ownship_speed();
   // Iterate on all traffic aircraft
   for (int ac = 0; ac < static_cast<int>(core.traffic.size()); ++ac) {
     const TrafficState& intruder = core.traffic[ac];
-    int alerter_idx = core.alerter_index_of(intruder);
+    int alerter_idx = core.traffic_alerter_index(ac);
     if (1 <= alerter_idx && alerter_idx <= core.parameters.numberOfAlerters()) {
       const Alerter& alerter = core.parameters.getAlerterAt(alerter_idx);
       // Assumes that thresholds of severe alerts are included in the volume of less severe alerts
@@ -282,9 +311,12 @@ void DaidalusRealBands::peripheral_aircraft(DaidalusCore& core, int conflict_reg
       int alert_level = alerter.alertLevelForRegion(region);
       if (alert_level > 0) {
         Detection3D* detector = alerter.getLevel(alert_level).getCoreDetectionPtr();
+        if (core.out_of_range(detector,ac,max_own_speed,core.parameters.getLookaheadTime())) {
+          continue;
+        }
         double alerting_time = Util::min(core.parameters.getLookaheadTime(),
             alerter.getLevel(alert_level).getAlertingTime());
-        ConflictData det = detector->conflictDetectionWithTrafficState(core.ownship,intruder,0.0,core.parameters.getLookaheadTime());
+        ConflictData det = core.conflict_detection(detector,ac,0.0,core.parameters.getLookaheadTime());
         if (!det.conflictBefore(alerting_time) && kinematic_conflict(core.parameters,core.ownship,intruder,detector,
             core.epsilonH(false,intruder),core.epsilonV(false,intruder),alerting_time,
             core.DTAStatus())) {
@@ -367,6 +399,40 @@ void DaidalusRealBands::saturateNoneIntervalSet(IntervalSet& noneset) const {
   }
 }
 
+/**
+ * Compute in noneset the none bands for aircraft in ilt. Uses aircraft detector if parameter
+ * detector is none. Return false if the alerter of the aircraft is out of bounds.
+ */
+bool DaidalusRealBands::aircraft_none_bands(IntervalSet& noneset, const IndexLevelT& ilt,
+    Detection3D* det, Detection3D* recovery,
+    bool recovery_case, double B, DaidalusCore& core) const {
+  const TrafficState& intruder = core.traffic[ilt.index];
+  int alerter_idx = core.traffic_alerter_index(ilt.index);
+  if (1 <= alerter_idx && alerter_idx <= core.parameters.numberOfAlerters()) {
+    const Alerter& alerter = core.parameters.getAlerterAt(alerter_idx);
+    Detection3D* detector = (det == NULL ? alerter.getLevel(ilt.level).getCoreDetectionPtr() : det);
+    double T = ilt.time_horizon;
+    if (B > T) {
+      // This case corresponds to recovery bands, where B is a recovery time.
+      // If recovery time is greater than lookahead time for aircraft, then only
+      // the internal cylinder is checked until this time.
+      if (recovery != NULL) {
+        none_bands(noneset,recovery,NULL,
+            core.epsilonH(recovery_case,intruder),core.epsilonV(recovery_case,intruder),0,T,
+            core.parameters,core.ownship,intruder);
+      } else {
+        saturateNoneIntervalSet(noneset);
+      }
+    } else if (B <= T) {
+      none_bands(noneset,detector,recovery,
+          core.epsilonH(recovery_case,intruder),core.epsilonV(recovery_case,intruder),B,T,
+          core.parameters,core.ownship,intruder);
+    }
+    return true;
+  }
+  return false;
+}
+
 /**
  * Compute none bands for a const std::vector<IndexLevelT>& ilts of IndexLevelT in none_set_region.
  * The none_set_region is initiated as a saturated green band.
@@ -376,33 +442,17 @@ void DaidalusRealBands::saturateNoneIntervalSet(IntervalSet& noneset) const {
 void DaidalusRealBands::compute_none_bands(IntervalSet& none_set_region, const std::vector<IndexLevelT>& ilts,
     Detection3D* det, Detection3D* recovery,
     bool recovery_case, double B, DaidalusCore& core) {
+  if (parallel_ && ilts.size() > 1 && DaidalusThreadPool::shared().getNumberOfThreads() > 0) {
+    compute_none_bands_parallel(none_set_region,ilts,det,recovery,recovery_case,B,core);
+    return;
+  }
   saturateNoneIntervalSet(none_set_region);
   // Compute bands for given region
+  IntervalSet noneset2;
   std::vector<IndexLevelT>::const_iterator ilt_ptr;
   for (ilt_ptr = ilts.begin(); ilt_ptr != ilts.end(); ++ilt_ptr) {
-    const TrafficState& intruder = core.traffic[ilt_ptr->index];
-    int alerter_idx = core.alerter_index_of(intruder);
-    if (1 <= alerter_idx && alerter_idx <= core.parameters.numberOfAlerters()) {
-      const Alerter& alerter = core.parameters.getAlerterAt(alerter_idx);
-      Detection3D* detector = (det == NULL ? alerter.getLevel(ilt_ptr->level).getCoreDetectionPtr() : det);
-      IntervalSet noneset2 = IntervalSet();
-      double T = ilt_ptr->time_horizon;
-      if (B > T) {
-        // This case corresponds to recovery bands, where B is a recovery time.
-        // If recovery time is greater than lookahead time for aircraft, then only
-        // the internal cylinder is checked until this time.
-        if (recovery != NULL) {
-          none_bands(noneset2,recovery,NULL,
-              core.epsilonH(recovery_case,intruder),core.epsilonV(recovery_case,intruder),0,T,
-              core.parameters,core.ownship,intruder);
-        } else {
-          saturateNoneIntervalSet(noneset2);
-        }
-      } else if (B <= T) {
-        none_bands(noneset2,detector,recovery,
-            core.epsilonH(recovery_case,intruder),core.epsilonV(recovery_case,intruder),B,T,
-            core.parameters,core.ownship,intruder);
-      }
+    noneset2.clear();
+    if (aircraft_none_bands(noneset2,*ilt_ptr,det,recovery,recovery_case,B,core)) {
       none_set_region.almost_intersect(noneset2,DaidalusParameters::ALMOST_);
       if (none_set_region.isEmpty()) {
         break; // No need to compute more bands. This region is currently saturated.
@@ -411,6 +461,49 @@ void DaidalusRealBands::compute_none_bands(IntervalSet& none_set_region, const s
   }
 }
 
+/**
+ * Parallel version of compute_none_bands. This is a fork-join over aircraft: one task per aircraft
+ * is pushed into the FIFO queue of DaidalusThreadPool, idle threads (including the caller) take the
+ * next task, and the caller waits for all of them. There is no per-thread queue nor work stealing.
+ * None bands are intersected in the same order as in the sequential version.
+ */
+void DaidalusRealBands::compute_none_bands_parallel(IntervalSet& none_set_region, const std::vector<IndexLevelT>& ilts,
+    Detection3D* det, Detection3D* recovery,
+    bool recovery_case, double B, DaidalusCore& core) const {
+  saturateNoneIntervalSet(none_set_region);
+  int n = static_cast<int>(ilts.size());
+  std::vector<IntervalSet> nonesets(n);
+  // Status of each aircraft: -1: not computed, 0: alerter out of bounds, 1: computed
+  std::vector<int> status(n,-1);
+  // An empty none set saturates the region. In that case, aircraft that haven't been processed yet
+  // are skipped, since the sequential version would stop at that aircraft or before.
+  std::atomic<bool> saturated(false);
+  std::vector<std::function<void()> > tasks;
+  for (int i = 0; i < n; ++i) {
+    tasks.push_back([&,i]() {
+      if (!saturated.load()) {
+        status[i] = aircraft_none_bands(nonesets[i],ilts[i],det,recovery,recovery_case,B,core) ? 1 : 0;
+        if (status[i] > 0 && nonesets[i].isEmpty()) {
+          saturated.store(true);
+        }
+      }
+    });
+  }
+  DaidalusThreadPool::shared().run(tasks);
+  for (int i = 0; i < n; ++i) {
+    if (status[i] < 0) {
+      // Skipped aircraft that precede the saturating one are computed here
+      status[i] = aircraft_none_bands(nonesets[i],ilts[i],det,recovery,recovery_case,B,core) ? 1 : 0;
+    }
+    if (status[i] > 0) {
+      none_set_region.almost_intersect(nonesets[i],DaidalusParameters::ALMOST_);
+      if (none_set_region.isEmpty()) {
+        break; // No need to intersect more bands. This region is currently saturated.
+      }
+    }
+  }
+}
+
 /**
  * Compute recovery bands. Class variables recovery_time_, recovery_horizontal_distance_,
  * and recovery_vertical_distance_ are set.
@@ -0,0 +1,424 @@
+/*
+ * Copyright (c) 2015-2021 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+
+#include "DaidalusResults.h"
+#include "Daidalus.h"
+#include "DaidalusRealBands.h"
+#include "IndexLevelT.h"
+#include "Util.h"
+
+namespace larcfm {
+
+DaidalusResults::Bands::Bands() :
+    mod(0),
+    preferred(false),
+    recovery(NaN,0,NaN,NaN),
+    peripheral_acs(BandsRegion::NUMBER_OF_CONFLICT_BANDS) {
+  resolution[0] = resolution[1] = NaN;
+  raw_resolution[0] = raw_resolution[1] = NaN;
+}
+
+int DaidalusResults::Bands::length() const {
+  return static_cast<int>(ranges.size());
+}
+
+Interval DaidalusResults::Bands::interval(int i) const {
+  if (i < 0 || i >= length()) {
+    return Interval::EMPTY;
+  }
+  return ranges[i].interval;
+}
+
+Interval DaidalusResults::Bands::interval(int i, const std::string& u) const {
+  Interval ia = interval(i);
+  if (ia.isEmpty()) {
+    return ia;
+  }
+  return Interval(Units::to(u, ia.low), Units::to(u, ia.up));
+}
+
+Interval DaidalusResults::Bands::interval(int i, Unit u) const {
+  Interval ia = interval(i);
+  if (ia.isEmpty()) {
+    return ia;
+  }
+  return Interval(Units::to(u, ia.low), Units::to(u, ia.up));
+}
+
+BandsRegion::Region DaidalusResults::Bands::region(int i) const {
+  if (i < 0 || i >= length()) {
+    return BandsRegion::UNKNOWN;
+  }
+  return ranges[i].region;
+}
+
+int DaidalusResults::Bands::indexOf(double val) const {
+  if (ranges.empty()) {
+    return -1;
+  }
+  return BandsRange::index_of(ranges,val,mod);
+}
+
+void DaidalusResults::Bands::peripheralAircraft(std::vector<std::string>& acs, int region) const {
+  if (0 < region && region <= BandsRegion::NUMBER_OF_CONFLICT_BANDS) {
+    acs = peripheral_acs[region-1];
+  } else {
+    acs.clear();
+  }
+}
+
+double DaidalusResults::Bands::lastTimeToManeuver(int ac_idx) const {
+  if (1 <= ac_idx && ac_idx <= static_cast<int>(last_time_to_maneuver.size())) {
+    return last_time_to_maneuver[ac_idx-1];
+  }
+  return NaN;
+}
+
+DaidalusResults::DaidalusResults() :
+    current_time_(0),
+    conflict_acs_(BandsRegion::NUMBER_OF_CONFLICT_BANDS),
+    time_interval_of_conflict_(BandsRegion::NUMBER_OF_CONFLICT_BANDS,Interval::EMPTY),
+    dta_status_(0) {}
+
+DaidalusResults::DaidalusResults(Daidalus& daa) :
+    current_time_(daa.getCurrentTime()),
+    conflict_acs_(BandsRegion::NUMBER_OF_CONFLICT_BANDS),
+    time_interval_of_conflict_(BandsRegion::NUMBER_OF_CONFLICT_BANDS,Interval::EMPTY),
+    dta_status_(0) {
+  if (!daa.hasOwnship()) {
+    return;
+  }
+  // Bands in all dimensions are computed at once. From here on, all values are read from caches.
+  daa.refreshBands();
+  for (int ac_idx = 0; ac_idx <= daa.lastTrafficIndex(); ++ac_idx) {
+    const TrafficState& ac = daa.getAircraftStateAt(ac_idx);
+    aircraft_.push_back(ac);
+    aircraft_idx_[ac.getId()] = ac_idx;
+    alert_levels_.push_back(ac_idx == 0 ? -1 : daa.alertLevel(ac_idx));
+    time_to_corrective_volume_.push_back(ac_idx == 0 ? NaN : daa.timeToCorrectiveVolume(ac_idx));
+  }
+  for (int region = 1; region <= BandsRegion::NUMBER_OF_CONFLICT_BANDS; ++region) {
+    daa.conflictBandsAircraft(conflict_acs_[region-1],region);
+    time_interval_of_conflict_[region-1] = daa.timeIntervalOfConflict(region);
+  }
+  dta_status_ = daa.core_.DTAStatus();
+  snapshotBands(hdir_,daa.hdir_band_,daa);
+  snapshotBands(hs_,daa.hs_band_,daa);
+  snapshotBands(vs_,daa.vs_band_,daa);
+  snapshotBands(alt_,daa.alt_band_,daa);
+}
+
+void DaidalusResults::snapshotBands(Bands& bands, DaidalusRealBands& band, Daidalus& daa) {
+  DaidalusCore& core = daa.core_;
+  bands.ranges = band.ranges(core);
+  bands.mod = band.get_mod();
+  for (int dir = 0; dir <= 1; ++dir) {
+    bands.resolution[dir] = band.resolution(core,dir == 1);
+    bands.raw_resolution[dir] = band.raw_resolution(core,dir == 1);
+  }
+  bands.preferred = band.preferred_direction(core);
+  bands.recovery = band.recoveryInformation(core);
+  for (int region = 1; region <= BandsRegion::NUMBER_OF_CONFLICT_BANDS; ++region) {
+    IndexLevelT::toStringList(bands.peripheral_acs[region-1],
+        band.acs_peripheral_bands(core,BandsRegion::NUMBER_OF_CONFLICT_BANDS-region),core.traffic);
+  }
+  for (int ac = 0; ac < static_cast<int>(core.traffic.size()); ++ac) {
+    double lt2m = band.last_time_to_maneuver(core,core.traffic[ac]);
+    bands.last_time_to_maneuver.push_back(ISNAN(lt2m) ? PINFINITY : lt2m);
+  }
+}
+
+double DaidalusResults::getCurrentTime() const {
+  return current_time_;
+}
+
+bool DaidalusResults::hasOwnship() const {
+  return !aircraft_.empty();
+}
+
+int DaidalusResults::numberOfAircraft() const {
+  return static_cast<int>(aircraft_.size());
+}
+
+int DaidalusResults::lastTrafficIndex() const {
+  return numberOfAircraft()-1;
+}
+
+int DaidalusResults::aircraftIndex(const std::string& name) const {
+  std::map<std::string,int>::const_iterator it = aircraft_idx_.find(name);
+  return it != aircraft_idx_.end() ? it->second : -1;
+}
+
+const TrafficState& DaidalusResults::getAircraftStateAt(int idx) const {
+  if (0 <= idx && idx <= lastTrafficIndex()) {
+    return aircraft_[idx];
+  }
+  return TrafficState::INVALID();
+}
+
+int DaidalusResults::alertLevel(int ac_idx) const {
+  if (1 <= ac_idx && ac_idx <= lastTrafficIndex()) {
+    return alert_levels_[ac_idx];
+  }
+  return -1;
+}
+
+double DaidalusResults::timeToCorrectiveVolume(int ac_idx) const {
+  if (1 <= ac_idx && ac_idx <= lastTrafficIndex()) {
+    return time_to_corrective_volume_[ac_idx];
+  }
+  return NaN;
+}
+
+void DaidalusResults::conflictBandsAircraft(std::vector<std::string>& acs, int region) const {
+  if (0 < region && region <= BandsRegion::NUMBER_OF_CONFLICT_BANDS) {
+    acs = conflict_acs_[region-1];
+  } else {
+    acs.clear();
+  }
+}
+
+void DaidalusResults::conflictBandsAircraft(std::vector<std::string>& acs, BandsRegion::Region region) const {
+  conflictBandsAircraft(acs,BandsRegion::orderOfRegion(region));
+}
+
+Interval DaidalusResults::timeIntervalOfConflict(int region) const {
+  if (0 < region && region <= BandsRegion::NUMBER_OF_CONFLICT_BANDS) {
+    return time_interval_of_conflict_[region-1];
+  }
+  return Interval::EMPTY;
+}
+
+Interval DaidalusResults::timeIntervalOfConflict(BandsRegion::Region region) const {
+  return timeIntervalOfConflict(BandsRegion::orderOfRegion(region));
+}
+
+bool DaidalusResults::isActiveDTALogic() const {
+  return dta_status_ != 0;
+}
+
+bool DaidalusResults::isActiveDTASpecialManeuverGuidance() const {
+  return dta_status_ > 0;
+}
+
+/* Horizontal direction bands */
+
+int DaidalusResults::horizontalDirectionBandsLength() const {
+  return hdir_.length();
+}
+
+Interval DaidalusResults::horizontalDirectionIntervalAt(int i) const {
+  return hdir_.interval(i);
+}
+
+Interval DaidalusResults::horizontalDirectionIntervalAt(int i, const std::string& u) const {
+  return hdir_.interval(i,u);
+}
+
+Interval DaidalusResults::horizontalDirectionIntervalAt(int i, Unit u) const {
+  return hdir_.interval(i,u);
+}
+
+BandsRegion::Region DaidalusResults::horizontalDirectionRegionAt(int i) const {
+  return hdir_.region(i);
+}
+
+int DaidalusResults::indexOfHorizontalDirection(double dir) const {
+  return hdir_.indexOf(dir);
+}
+
+BandsRegion::Region DaidalusResults::regionOfHorizontalDirection(double dir) const {
+  return hdir_.region(hdir_.indexOf(dir));
+}
+
+double DaidalusResults::horizontalDirectionResolution(bool dir) const {
+  return hdir_.resolution[dir ? 1 : 0];
+}
+
+double DaidalusResults::horizontalDirectionRawResolution(bool dir) const {
+  return hdir_.raw_resolution[dir ? 1 : 0];
+}
+
+bool DaidalusResults::preferredHorizontalDirectionRightOrLeft() const {
+  return hdir_.preferred;
+}
+
+RecoveryInformation DaidalusResults::horizontalDirectionRecoveryInformation() const {
+  return hdir_.recovery;
+}
+
+void DaidalusResults::peripheralHorizontalDirectionBandsAircraft(std::vector<std::string>& acs, int region) const {
+  hdir_.peripheralAircraft(acs,region);
+}
+
+double DaidalusResults::lastTimeToHorizontalDirectionManeuver(int ac_idx) const {
+  return hdir_.lastTimeToManeuver(ac_idx);
+}
+
+/* Horizontal speed bands */
+
+int DaidalusResults::horizontalSpeedBandsLength() const {
+  return hs_.length();
+}
+
+Interval DaidalusResults::horizontalSpeedIntervalAt(int i) const {
+  return hs_.interval(i);
+}
+
+Interval DaidalusResults::horizontalSpeedIntervalAt(int i, const std::string& u) const {
+  return hs_.interval(i,u);
+}
+
+Interval DaidalusResults::horizontalSpeedIntervalAt(int i, Unit u) const {
+  return hs_.interval(i,u);
+}
+
+BandsRegion::Region DaidalusResults::horizontalSpeedRegionAt(int i) const {
+  return hs_.region(i);
+}
+
+int DaidalusResults::indexOfHorizontalSpeed(double gs) const {
+  return hs_.indexOf(gs);
+}
+
+BandsRegion::Region DaidalusResults::regionOfHorizontalSpeed(double gs) const {
+  return hs_.region(hs_.indexOf(gs));
+}
+
+double DaidalusResults::horizontalSpeedResolution(bool dir) const {
+  return hs_.resolution[dir ? 1 : 0];
+}
+
+double DaidalusResults::horizontalSpeedRawResolution(bool dir) const {
+  return hs_.raw_resolution[dir ? 1 : 0];
+}
+
+bool DaidalusResults::preferredHorizontalSpeedUpOrDown() const {
+  return hs_.preferred;
+}
+
+RecoveryInformation DaidalusResults::horizontalSpeedRecoveryInformation() const {
+  return hs_.recovery;
+}
+
+void DaidalusResults::peripheralHorizontalSpeedBandsAircraft(std::vector<std::string>& acs, int region) const {
+  hs_.peripheralAircraft(acs,region);
+}
+
+double DaidalusResults::lastTimeToHorizontalSpeedManeuver(int ac_idx) const {
+  return hs_.lastTimeToManeuver(ac_idx);
+}
+
+/* Vertical speed bands */
+
+int DaidalusResults::verticalSpeedBandsLength() const {
+  return vs_.length();
+}
+
+Interval DaidalusResults::verticalSpeedIntervalAt(int i) const {
+  return vs_.interval(i);
+}
+
+Interval DaidalusResults::verticalSpeedIntervalAt(int i, const std::string& u) const {
+  return vs_.interval(i,u);
+}
+
+Interval DaidalusResults::verticalSpeedIntervalAt(int i, Unit u) const {
+  return vs_.interval(i,u);
+}
+
+BandsRegion::Region DaidalusResults::verticalSpeedRegionAt(int i) const {
+  return vs_.region(i);
+}
+
+int DaidalusResults::indexOfVerticalSpeed(double vs) const {
+  return vs_.indexOf(vs);
+}
+
+BandsRegion::Region DaidalusResults::regionOfVerticalSpeed(double vs) const {
+  return vs_.region(vs_.indexOf(vs));
+}
+
+double DaidalusResults::verticalSpeedResolution(bool dir) const {
+  return vs_.resolution[dir ? 1 : 0];
+}
+
+double DaidalusResults::verticalSpeedRawResolution(bool dir) const {
+  return vs_.raw_resolution[dir ? 1 : 0];
+}
+
+bool DaidalusResults::preferredVerticalSpeedUpOrDown() const {
+  return vs_.preferred;
+}
+
+RecoveryInformation DaidalusResults::verticalSpeedRecoveryInformation() const {
+  return vs_.recovery;
+}
+
+void DaidalusResults::peripheralVerticalSpeedBandsAircraft(std::vector<std::string>& acs, int region) const {
+  vs_.peripheralAircraft(acs,region);
+}
+
+double DaidalusResults::lastTimeToVerticalSpeedManeuver(int ac_idx) const {
+  return vs_.lastTimeToManeuver(ac_idx);
+}
+
+/* Altitude bands */
+
+int DaidalusResults::altitudeBandsLength() const {
+  return alt_.length();
+}
+
+Interval DaidalusResults::altitudeIntervalAt(int i) const {
+  return alt_.interval(i);
+}
+
+Interval DaidalusResults::altitudeIntervalAt(int i, const std::string& u) const {
+  return alt_.interval(i,u);
+}
+
+Interval DaidalusResults::altitudeIntervalAt(int i, Unit u) const {
+  return alt_.interval(i,u);
+}
+
+BandsRegion::Region DaidalusResults::altitudeRegionAt(int i) const {
+  return alt_.region(i);
+}
+
+int DaidalusResults::indexOfAltitude(double alt) const {
+  return alt_.indexOf(alt);
+}
+
+BandsRegion::Region DaidalusResults::regionOfAltitude(double alt) const {
+  return alt_.region(alt_.indexOf(alt));
+}
+
+double DaidalusResults::altitudeResolution(bool dir) const {
+  return alt_.resolution[dir ? 1 : 0];
+}
+
+double DaidalusResults::altitudeRawResolution(bool dir) const {
+  return alt_.raw_resolution[dir ? 1 : 0];
+}
+
+bool DaidalusResults::preferredAltitudeUpOrDown() const {
+  return alt_.preferred;
+}
+
+RecoveryInformation DaidalusResults::altitudeRecoveryInformation() const {
+  return alt_.recovery;
+}
+
+void DaidalusResults::peripheralAltitudeBandsAircraft(std::vector<std::string>& acs, int region) const {
+  alt_.peripheralAircraft(acs,region);
+}
+
+double DaidalusResults::lastTimeToAltitudeManeuver(int ac_idx) const {
+  return alt_.lastTimeToManeuver(ac_idx);
+}
+
+}
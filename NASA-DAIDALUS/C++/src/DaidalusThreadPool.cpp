@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2015-2021 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+#include "DaidalusThreadPool.h"
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace larcfm {
+
+/* Number of tasks of a call to run that are still pending */
+class DaidalusThreadPool::Batch {
+public:
+  int pending;
+  std::condition_variable done;
+  Batch(int n) : pending(n) {}
+};
+
+DaidalusThreadPool::Job::Job(const std::function<void()>* t, Batch* b) : task(t), batch(b) {}
+
+DaidalusThreadPool::DaidalusThreadPool() : stopping_(false) {}
+
+DaidalusThreadPool::~DaidalusThreadPool() {
+  stop_workers();
+}
+
+/**
+ * Return the thread pool shared by all Daidalus objects.
+ */
+DaidalusThreadPool& DaidalusThreadPool::shared() {
+  // The shared pool is never deleted so that worker threads are not joined during static
+  // destruction, e.g., when the library is unloaded
+  static DaidalusThreadPool* pool = new DaidalusThreadPool();
+  return *pool;
+}
+
+void DaidalusThreadPool::stop_workers() {
+  std::vector<std::thread> workers;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+    workers.swap(workers_);
+  }
+  jobs_cv_.notify_all();
+  for (int i = 0; i < static_cast<int>(workers.size()); ++i) {
+    workers[i].join();
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  stopping_ = false;
+}
+
+// Main loop of worker threads. Pending jobs are done before the worker stops.
+void DaidalusThreadPool::work() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    if (!jobs_.empty()) {
+      Job job = jobs_.front();
+      jobs_.pop_front();
+      lock.unlock();
+      execute(job);
+      lock.lock();
+    } else if (stopping_) {
+      return;
+    } else {
+      jobs_cv_.wait(lock);
+    }
+  }
+}
+
+// Run job and notify its batch. Requires that mutex_ is not locked by the calling thread.
+void DaidalusThreadPool::execute(const Job& job) {
+  (*job.task)();
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Notification is done while mutex_ is locked, since the batch is destroyed as soon as
+  // the thread waiting on it sees that no tasks are pending
+  if (--job.batch->pending == 0) {
+    job.batch->done.notify_all();
+  }
+}
+
+/**
+ * Set number of worker threads. A value less than or equal to 0 removes all worker threads, in which
+ * case tasks are run sequentially in the calling thread.
+ */
+void DaidalusThreadPool::setNumberOfThreads(int n) {
+  stop_workers();
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (int i = 0; i < n; ++i) {
+    workers_.push_back(std::thread(&DaidalusThreadPool::work,this));
+  }
+}
+
+/**
+ * Return number of worker threads.
+ */
+int DaidalusThreadPool::getNumberOfThreads() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return static_cast<int>(workers_.size());
+}
+
+/**
+ * Run all tasks and return when all of them are done. Tasks are run concurrently by the worker
+ * threads and the calling thread.
+ */
+void DaidalusThreadPool::run(const std::vector<std::function<void()> >& tasks) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (workers_.empty() || tasks.size() <= 1) {
+    lock.unlock();
+    for (int i = 0; i < static_cast<int>(tasks.size()); ++i) {
+      tasks[i]();
+    }
+    return;
+  }
+  Batch batch(static_cast<int>(tasks.size())-1);
+  for (int i = 1; i < static_cast<int>(tasks.size()); ++i) {
+    jobs_.push_back(Job(&tasks[i],&batch));
+  }
+  lock.unlock();
+  jobs_cv_.notify_all();
+  tasks[0]();
+  lock.lock();
+  // While waiting, the calling thread helps with pending jobs. This guarantees progress when
+  // there are no idle workers, e.g., in nested batches.
+  while (batch.pending > 0) {
+    if (!jobs_.empty()) {
+      Job job = jobs_.front();
+      jobs_.pop_front();
+      lock.unlock();
+      execute(job);
+      lock.lock();
+    } else {
+      batch.done.wait(lock);
+    }
+  }
+}
+
+}
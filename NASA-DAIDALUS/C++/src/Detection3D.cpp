@@ -7,6 +7,9 @@
 
 #include "Detection3D.h"
 #include "ConflictData.h"
+#include "Util.h"
+#include <algorithm>
+#include <cmath>
 
 namespace larcfm {
 
@@ -87,18 +90,156 @@ ConflictData Detection3D::conflictDetectionWithTrafficState(const TrafficState&
   return conflictDetection(ownship.get_s(),ownship.get_v(),intruder.get_s(),intruder.get_v(),B,T);
 }
 
-void Detection3D::add_blob(std::vector<std::vector<Position> >& blobs, std::vector<Position>& vin, std::vector<Position>& vout) {
+/**
+ * Batched version of conflictDetection for one intruder and a list of ownship velocities. On return,
+ * dets[k] is the same as conflictDetection(so,vos[k],si,vi,B,T).
+ */
+void Detection3D::conflictDetectionVelocities(std::vector<ConflictData>& dets, const Vect3& so, const std::vector<Velocity>& vos,
+    const Vect3& si, const Velocity& vi, double B, double T) const {
+  dets.clear();
+  dets.reserve(vos.size());
+  for (std::vector<Velocity>::const_iterator vo_ptr = vos.begin(); vo_ptr != vos.end(); ++vo_ptr) {
+    dets.push_back(conflictDetection(so,*vo_ptr,si,vi,B,T));
+  }
+}
+
+/**
+ * Batched version of conflictDetectionWithTrafficState for one intruder and a list of ownship states
+ * that only differ in their velocities. On return, dets[k] is the same as
+ * conflictDetectionWithTrafficState(owns[k],intruder,B,T). Detectors that only use positions and velocities
+ * reduce to conflictDetectionVelocities.
+ */
+void Detection3D::conflictDetectionWithTrafficStates(std::vector<ConflictData>& dets, const std::vector<TrafficState>& owns,
+    const TrafficState& intruder, double B, double T) const {
+  if (owns.empty()) {
+    dets.clear();
+    return;
+  }
+  std::vector<Velocity> vos;
+  vos.reserve(owns.size());
+  for (std::vector<TrafficState>::const_iterator own_ptr = owns.begin(); own_ptr != owns.end(); ++own_ptr) {
+    vos.push_back(own_ptr->get_v());
+  }
+  conflictDetectionVelocities(dets,owns[0].get_s(),vos,intruder.get_s(),intruder.get_v(),B,T);
+}
+
+bool Detection3D::horizontalCriticalTracks(std::vector<double>& trks, const Vect3& so, const Velocity& co, double r, const Vect3& si, const Velocity& vi,
+    double B, double T) const {
+  return false;
+}
+
+double Detection3D::horizontalViolationRange(double vh) const {
+  return PINFINITY;
+}
+
+void Detection3D::add_blob(std::vector<std::vector<Position> >& blobs, std::deque<Position>& vin, std::deque<Position>& vout) {
   if (vin.empty() && vout.empty()) {
     return;
   }
   // Add conflict contour
-  std::vector<Position> blob = vin;
+  std::vector<Position> blob;
+  blob.reserve(vin.size()+vout.size());
+  blob.insert(blob.end(), vin.begin(), vin.end());
   blob.insert(blob.end(), vout.begin(), vout.end());
   blobs.push_back(blob);
   vin.clear();
   vout.clear();
 }
 
+bool Detection3D::contour_critical_directions(std::vector<double>& crit, const TrafficState& ownship, const Velocity& vo,
+    const TrafficState& intruder, double T) const {
+  if (T <= 0) {
+    return false;
+  }
+  // Critical tracks are defined for ownship velocities in a circle, which is checked on the projected velocities
+  double trk = vo.trk();
+  TrafficState own = ownship;
+  own.setAirVelocity(vo.mkTrk(trk));
+  Velocity v0 = own.get_v();
+  own.setAirVelocity(vo.mkTrk(trk+Pi/2));
+  Velocity v1 = own.get_v();
+  own.setAirVelocity(vo.mkTrk(trk+Pi));
+  Velocity v2 = own.get_v();
+  own.setAirVelocity(vo.mkTrk(trk+3*Pi/2));
+  Velocity v3 = own.get_v();
+  Velocity co = Velocity::make(v0.Add(v2).Scal(0.5));
+  Vect2 u0 = v0.vect2().Sub(co.vect2());
+  double r = u0.norm();
+  double eps = 1E-9*r;
+  if (Util::almost_equals(r,0) ||
+      v1.vect2().Sub(co.vect2()).Sub(u0.PerpR()).norm() > eps ||
+      v3.vect2().Sub(co.vect2()).Sub(u0.PerpL()).norm() > eps ||
+      std::abs(v1.z-co.z) > eps || std::abs(v3.z-co.z) > eps) {
+    return false;
+  }
+  std::vector<double> trks;
+  if (!horizontalCriticalTracks(trks,own.get_s(),co,r,intruder.get_s(),intruder.get_v(),0.0,T)) {
+    return false;
+  }
+  double trk0 = u0.compassAngle();
+  for (int i = 0; i < static_cast<int>(trks.size()); ++i) {
+    crit.push_back(Util::to_2pi(trks[i]-trk0));
+  }
+  std::sort(crit.begin(),crit.end());
+  return true;
+}
+
+void Detection3D::contour_sweep_batch(ContourSweep& sweep, TrafficState& own, const Velocity& vo, const TrafficState& intruder,
+    double T, int i) const {
+  // Most contours span several degrees, and the whole circle is swept when the contour threshold is pi
+  const int batch = 36;
+  double step = Pi/180;
+  double current_trk = vo.trk();
+  int n = Util::max(batch,i+1-static_cast<int>(sweep.dets.size()));
+  std::vector<TrafficState> owns;
+  owns.reserve(n);
+  for (int k = 0; k < n; ++k) {
+    // Directions are accumulated as in horizontalContours so that they are the same as the ones of the sweep
+    own.setAirVelocity(vo.mkTrk(current_trk+sweep.sign*sweep.next));
+    owns.push_back(own);
+    sweep.next += step;
+  }
+  std::vector<ConflictData> dets;
+  conflictDetectionWithTrafficStates(dets,owns,intruder,0.0,T);
+  sweep.dets.insert(sweep.dets.end(),dets.begin(),dets.end());
+}
+
+bool Detection3D::contour_conflict(LossData& los, TrafficState& own, const Velocity& vo, const Velocity& vop, const TrafficState& intruder,
+    double T, double x, ContourSweep& sweep, int i, const std::vector<double>& crit, std::vector<int>& cell_status) const {
+  if (cell_status.empty()) {
+    if (i >= static_cast<int>(sweep.dets.size())) {
+      contour_sweep_batch(sweep,own,vo,intruder,T,i);
+    }
+    los = sweep.dets[i];
+    return los.conflict();
+  }
+  // Directions closer than near to a critical direction are checked one by one. Since the conflict status
+  // doesn't change between consecutive critical directions, the remaining directions between them are only
+  // checked until one of them is found to be conflict free.
+  const double near = Pi/720;
+  int n = crit.size();
+  int cell = 0;
+  if (n > 0) {
+    int i = std::lower_bound(crit.begin(),crit.end(),x)-crit.begin();
+    double next = i < n ? crit[i] : crit[0]+2*Pi;
+    double prev = i > 0 ? crit[i-1] : crit[n-1]-2*Pi;
+    if (next-x <= near || x-prev <= near) {
+      own.setAirVelocity(vop);
+      los = conflictDetectionWithTrafficState(own,intruder,0.0,T);
+      return los.conflict();
+    }
+    cell = i % n;
+  }
+  if (cell_status[cell] > 0) {
+    return false;
+  }
+  own.setAirVelocity(vop);
+  los = conflictDetectionWithTrafficState(own,intruder,0.0,T);
+  bool conflict = los.conflict();
+  cell_status[cell] = conflict ? 0 : 1;
+  return conflict;
+}
+
 /**
  * Computes horizontal list of contours contributed by intruder aircraft. A contour is a
  * list of points in counter-clockwise direction representing a polygon.
@@ -110,27 +251,38 @@ void Detection3D::add_blob(std::vector<std::vector<Position> >& blobs, std::vect
  *
  * NOTE: The computed polygon should only be used for display purposes since it's merely an
  * approximation of the actual contours defined by the violation and detection methods.
+ *
+ * Directions are sampled every degree. When the detector supports critical tracks, the detection
+ * is skipped for directions that are known to be conflict free. Otherwise, the detection is computed
+ * for batches of consecutive directions through conflictDetectionWithTrafficStates.
  */
 void Detection3D::horizontalContours(std::vector<std::vector<Position> >& blobs, const TrafficState& ownship, const TrafficState& intruder,
     double thr, double T) const {
-  std::vector<Position> vin;
+  std::deque<Position> vin;
   const Position& po = ownship.getPosition();
   const Velocity& vo = ownship.getVelocity();
   double current_trk = vo.trk();
-  std::vector<Position> vout;
+  std::deque<Position> vout;
+  std::vector<double> crit;
+  std::vector<int> cell_status; // -1: unknown, 0: conflict, 1: conflict free
+  if (contour_critical_directions(crit,ownship,vo,intruder,T)) {
+    cell_status.assign(Util::max(1,static_cast<int>(crit.size())),-1);
+  }
+  LossData los;
   /* First step: Computes conflict contour (contour in the current path of the aircraft).
    * Get contour portion to the right.  If los.getTimeIn() == 0, a 360 degree
    * contour will be computed. Otherwise, stops at the first non-conflict degree.
    */
   double right = 0; // Contour conflict limit to the right relative to current direction  [0-2pi rad]
+  int i_right = 0;  // Number of steps in right
   double step = Pi/180;
   double two_pi = 2*Pi;
   TrafficState own = ownship;
-  for (; right < two_pi; right += step) {
+  ContourSweep right_sweep(1.0);
+  ContourSweep left_sweep(-1.0);
+  for (; right < two_pi; right += step, ++i_right) {
     Velocity vop = vo.mkTrk(current_trk+right);
-    own.setAirVelocity(vop);
-    LossData los = conflictDetectionWithTrafficState(own,intruder,0.0,T);
-    if ( !los.conflict() ) {
+    if (!contour_conflict(los,own,vo,vop,intruder,T,right,right_sweep,i_right,crit,cell_status)) {
       break;
     }
     if (los.getTimeIn() != 0 ) {
@@ -138,33 +290,30 @@ void Detection3D::horizontalContours(std::vector<std::vector<Position> >& blobs,
       vin.push_back(po.linear(vop,los.getTimeIn()));
     }
     // in any case, add position ad time out (counter clock-wise)
-    vout.insert(vout.begin(), po.linear(vop,los.getTimeOut()));
+    vout.push_front(po.linear(vop,los.getTimeOut()));
   }
   /* Second step: Compute conflict contour to the left */
   double left = 0;  // Contour conflict limit to the left relative to current direction [0-2pi rad]
+  int i_left = 0;   // Number of steps in left
   if (0 < right && right < two_pi) {
     /* There is a conflict contour, but not a violation */
-    for (left = step; left < two_pi; left += step) {
+    for (left = step, i_left = 1; left < two_pi; left += step, ++i_left) {
       Velocity vop = vo.mkTrk(current_trk-left);
-      own.setAirVelocity(vop);
-      LossData los = conflictDetectionWithTrafficState(own,intruder,0.0,T);
-      if ( !los.conflict() ) {
+      if (!contour_conflict(los,own,vo,vop,intruder,T,two_pi-left,left_sweep,i_left,crit,cell_status)) {
         break;
       }
-      vin.insert(vin.begin(), po.linear(vop,los.getTimeIn()));
+      vin.push_front(po.linear(vop,los.getTimeIn()));
       vout.push_back(po.linear(vop,los.getTimeOut()));
     }
   }
   add_blob(blobs,vin,vout);
   // Third Step: Look for other blobs to the right within direction threshold
   if (right < thr) {
-    for (; right < two_pi-left; right += step) {
+    for (; right < two_pi-left; right += step, ++i_right) {
       Velocity vop = vo.mkTrk(current_trk+right);
-      own.setAirVelocity(vop);
-      LossData los = conflictDetectionWithTrafficState(own,intruder,0.0,T);
-      if (los.conflict()) {
+      if (contour_conflict(los,own,vo,vop,intruder,T,right,right_sweep,i_right,crit,cell_status)) {
         vin.push_back(po.linear(vop,los.getTimeIn()));
-        vout.insert(vout.begin(), po.linear(vop,los.getTimeOut()));
+        vout.push_front(po.linear(vop,los.getTimeOut()));
       } else {
         add_blob(blobs,vin,vout);
         if (right >= thr) {
@@ -176,12 +325,10 @@ void Detection3D::horizontalContours(std::vector<std::vector<Position> >& blobs,
   }
   // Fourth Step: Look for other blobs to the left within direction threshold
   if (left < thr) {
-    for (; left < two_pi-right; left += step) {
+    for (; left < two_pi-right; left += step, ++i_left) {
       Velocity vop = vo.mkTrk(current_trk-left);
-      own.setAirVelocity(vop);
-      LossData los = conflictDetectionWithTrafficState(own,intruder,0.0,T);
-      if (los.conflict()) {
-        vin.insert(vin.begin(), po.linear(vop,los.getTimeIn()));
+      if (contour_conflict(los,own,vo,vop,intruder,T,two_pi-left,left_sweep,i_left,crit,cell_status)) {
+        vin.push_front(po.linear(vop,los.getTimeIn()));
         vout.push_back(po.linear(vop,los.getTimeOut()));
       } else {
         add_blob(blobs,vin,vout);
@@ -138,11 +138,11 @@ namespace larcfm {
 //      } else {  //0.5 nm accuracy
 //        return Units::from("NM", 205);
 //      }
-      return Units::from("NM", std::floor(243.0*std::pow(Units::to("NM",std::ceil(accuracy)),1.0/3.0)));
+      return Units::from(units::NM, std::floor(243.0*std::pow(Units::to(units::NM,std::ceil(accuracy)),1.0/3.0)));
    }
     
     double ENUProjection::maxRange() const{
-      return Units::from("NM", 3400);
+      return Units::from(units::NM, 3400);
     }
     
 	LatLonAlt ENUProjection::getProjectionPoint() const {
@@ -15,35 +15,38 @@
 #include "format.h"
 #include "ErrorLog.h"
 #include <iostream>
-#include <cstdlib>
-#include <cstring>
 #include <vector>
+#include <algorithm>
 
 using namespace std;
 using namespace larcfm;
 
-IntervalSet::IntervalSet() {
-	length = 0;
+IntervalSet::IntervalSet() : r(inline_r), length(0), capacity(inline_intervals) {
 }
 
-IntervalSet::IntervalSet(const IntervalSet& l) {
+IntervalSet::IntervalSet(const IntervalSet& l) : r(inline_r), length(0), capacity(inline_intervals) {
+	reserve(l.length);
+	std::copy(l.r,l.r+l.length,r);
 	length = l.length;
-
-	memcpy(r,l.r,sizeof(Interval)*length);
 }
 
-IntervalSet::IntervalSet(const std::vector<Interval>& v) {//: error("IntervalSet") {
+IntervalSet::IntervalSet(const std::vector<Interval>& v) : r(inline_r), length(0), capacity(inline_intervals) {//: error("IntervalSet") {
+	reserve(static_cast<int>(v.size()));
+	std::copy(v.begin(),v.end(),r);
 	length = static_cast<int>(v.size());
-	memcpy(r,&v[0],sizeof(Interval)*length);
 }
 
-std::vector<Interval> IntervalSet::toVector() const {
-	std::vector<Interval> v = std::vector<Interval>();
-	v.reserve(length); // note: reserve() is appropriate because we exclusively use push_back to populate the vector
-	for (int i = 0; i < length; i++) {
-		v.push_back(v[i]);
+IntervalSet& IntervalSet::operator=(const IntervalSet& l) {
+	if (this != &l) {
+		reserve(l.length);
+		std::copy(l.r,l.r+l.length,r);
+		length = l.length;
 	}
-	return v;
+	return *this;
+}
+
+std::vector<Interval> IntervalSet::toVector() const {
+	return std::vector<Interval>(r,r+length);
 }
 
 void IntervalSet::clear() {
@@ -75,6 +78,12 @@ void IntervalSet::unions(const Interval& rn) {
 		return;   //nothing to add
 	}
 
+	if (length == 0 || rn.low > r[length-1].up) {
+		// Interval goes after all the intervals in the set, e.g., when a set is built in order
+		insert(length, rn);
+		return;
+	}
+
 	int iLow = order(rn.low);
 	int iHigh = order(rn.up);
 
@@ -309,25 +318,10 @@ void IntervalSet::insert(int i, const Interval& region) {
 		i = length;
 	}
 
-	if (i == length && length < max_intervals) {
-		r[length] = region;
-		length++;
-	} else {
-		length++;
-		int c = length;
-
-		if (length >= max_intervals) {
-			std::cout << "ERROR: IntervalSet is full, fixing this requires a recompile" << endl;
-			exit(1);
-		}
-
-		while (i < c) {
-			r[c] = r[c-1];
-			c--;
-		}
-
-		r[i] = region;
-	}
+	reserve(length+1);
+	std::copy_backward(r+i,r+length,r+length+1);
+	r[i] = region;
+	length++;
 } // insert
 
 /* 
@@ -341,11 +335,7 @@ void IntervalSet::remove(int i) {
 
 	//	Interval t = r[i];
 
-	while (i + 1 < length) {
-		r[i] = r[i+1];
-		i++;
-	}
-
+	std::copy(r+i+1,r+length,r+i);
 	length--;
 
 	//return t;
@@ -355,9 +345,27 @@ void IntervalSet::remove(int i) {
  * Remove the len number of intervals starting at i.
  */
 void IntervalSet::remove(int i, int len) {
-	for( int j = 0; j < len; j++) {
-		remove(i);
+	if (i < 0 || i >= length || len <= 0) {
+		return;
+	}
+	len = Util::min(len, length-i);
+	std::copy(r+i+len,r+length,r+i);
+	length -= len;
+}
+
+/*
+ * Make room for at least n intervals. Intervals are moved to the heap
+ * when they don't fit in the inline storage.
+ */
+void IntervalSet::reserve(int n) {
+	if (n <= capacity) {
+		return;
 	}
+	std::vector<Interval> v(Util::max(n, 2*capacity));
+	std::copy(r,r+length,v.begin());
+	heap_r.swap(v);
+	r = &heap_r[0];
+	capacity = static_cast<int>(heap_r.size());
 }
 
 /* 
@@ -56,19 +56,19 @@ bool LatLonAlt::equals2D(const LatLonAlt& lla) const {
 }
 
 double LatLonAlt::decimal_angle(double degrees, double minutes, double seconds, bool north_east) {
-	return ((north_east) ? 1.0 : -1.0) * Units::from("deg", (degrees + minutes / 60.0 + seconds / 3600.0));
+	return ((north_east) ? 1.0 : -1.0) * Units::from(units::deg, (degrees + minutes / 60.0 + seconds / 3600.0));
 }
 
 double LatLonAlt::latitude() const {
-	return to_180(Units::to("deg", lati));
+	return to_180(Units::to(units::deg, lati));
 }
 
 double LatLonAlt::longitude() const {
-	return to_180(Units::to("deg", longi));
+	return to_180(Units::to(units::deg, longi));
 }
 
 double LatLonAlt::altitude() const {
-	return Units::to("ft", alti);
+	return Units::to(units::ft, alti);
 }
 
 double LatLonAlt::lat() const {
@@ -96,9 +96,9 @@ const LatLonAlt LatLonAlt::mk(const LatLonAlt& v) {
 }
 
 const LatLonAlt LatLonAlt::make(double lat, double lon, double alt){
-	return LatLonAlt(Units::from("deg", lat),
-			Units::from("deg", lon),
-			Units::from("ft", alt));
+	return LatLonAlt(Units::from(units::deg, lat),
+			Units::from(units::deg, lon),
+			Units::from(units::ft, alt));
 }
 
 const LatLonAlt LatLonAlt::make(double lat, std::string lat_unit, double lon, std::string lon_unit,
@@ -117,7 +117,7 @@ const LatLonAlt LatLonAlt::mkAlt(double alt) const {
 }
 
 const LatLonAlt LatLonAlt::makeAlt(double alt) const {
-	return LatLonAlt(lati, longi, Units::from("ft",alt));
+	return LatLonAlt(lati, longi, Units::from(units::ft,alt));
 }
 
 const LatLonAlt LatLonAlt::zeroAlt() const {
@@ -14,6 +14,7 @@
 #include "format.h"
 
 #include <vector>
+#include <algorithm>
 
 namespace larcfm {
 
@@ -45,17 +46,56 @@ MofN::MofN() {
 /*
  * Creates a copy of M of N object
  */
-MofN::MofN(const MofN& mofn) : m_(mofn.m_), n_(mofn.n_), max_(mofn.max_),
-    queue_(mofn.queue_) {}
+MofN::MofN(const MofN& mofn) : m_(mofn.m_), n_(mofn.n_), max_(mofn.max_), head_(mofn.head_),
+    heap_queue_(mofn.heap_queue_), heap_count_(mofn.heap_count_) {
+  std::copy(mofn.inline_queue_,mofn.inline_queue_+inline_size,inline_queue_);
+  std::copy(mofn.inline_count_,mofn.inline_count_+inline_size,inline_count_);
+}
+
+int* MofN::queue() {
+  return n_ > inline_size ? &heap_queue_[0] : inline_queue_;
+}
+
+const int* MofN::queue() const {
+  return n_ > inline_size ? &heap_queue_[0] : inline_queue_;
+}
+
+int* MofN::count() {
+  return heap_count_.empty() ? inline_count_ : &heap_count_[0];
+}
+
+/*
+ * Make room in count for values up to max. Counts of new values are 0.
+ */
+void MofN::reserve_count(int max) {
+  if (max < inline_size || max < static_cast<int>(heap_count_.size())) {
+    return;
+  }
+  if (heap_count_.empty()) {
+    heap_count_.assign(inline_count_,inline_count_+inline_size);
+  }
+  heap_count_.resize(max+1,0);
+}
 
 /*
  * Reset M of N object with a given initial value
  */
 void MofN::reset(int val) {
-  queue_.clear();
   max_ = val;
+  head_ = 0;
+  std::fill(inline_count_,inline_count_+inline_size,0);
+  heap_count_.clear();
+  reserve_count(val);
+  if (n_ > inline_size) {
+    heap_queue_.resize(n_);
+  }
+  int* q = queue();
+  int* c = count();
   for (int i=0;i<n_;++i) {
-    queue_.push_back(i < m_ ? val : -1);
+    q[i] = i < m_ ? val : -1;
+    if (q[i] >= 0) {
+      c[q[i]]++;
+    }
   }
 }
 
@@ -63,7 +103,7 @@ void MofN::reset(int val) {
  * Returns true if this object is able to perform M of N logic.
  */
 bool MofN::isValid() const {
-  return !queue_.empty() && m_ > 0 && m_ <= n_;
+  return n_ > 0 && m_ > 0 && m_ <= n_;
 }
 
 /*
@@ -77,21 +117,28 @@ int MofN::m_of_n(int value) {
     return value;
   }
   if (value > max_) {
+    reserve_count(value);
     max_ = value;
   }
-  queue_.pop_front();
-  queue_.push_back(value);
+  // The oldest value is replaced by the new one
+  int* q = queue();
+  int* c = count();
+  if (q[head_] >= 0) {
+    c[q[head_]]--;
+  }
+  q[head_] = value;
+  if (value >= 0) {
+    c[value]++;
+  }
+  head_ = head_+1 < n_ ? head_+1 : 0;
   if (max_ < 0) {
     return max_;
   }
-  std::vector<int> count(max_+1,0);
-  for (std::deque<int>::const_iterator val_ptr = queue_.begin(); val_ptr != queue_.end(); ++val_ptr) {
-    for (int i=*val_ptr;i >= 0;--i) {
-      count[i]++;
-    }
-  }
+  // Number of values greater than or equal to i
+  int count_ge = 0;
   for (int i=max_; i >= 0; --i) {
-    if (count[i] >= m_) {
+    count_ge += c[i];
+    if (count_ge >= m_) {
       return i;
     }
   }
@@ -99,31 +146,27 @@ int MofN::m_of_n(int value) {
 }
 
 bool MofN::sameAs(const MofN& mofn) const {
-  if (max_ != mofn.max_  && queue_.size() != mofn.queue_.size()) {
+  if (max_ != mofn.max_  && n_ != mofn.n_) {
       return false;
   }
-  std::deque<int>::const_iterator it1_ptr = queue_.begin();
-  std::deque<int>::const_iterator it2_ptr = mofn.queue_.begin();
-  while (it1_ptr != queue_.end() && it2_ptr != mofn.queue_.end()) {
-      if (*it1_ptr != *it2_ptr) {
+  const int* q1 = queue();
+  const int* q2 = mofn.queue();
+  for (int i=0; i < n_ && i < mofn.n_; ++i) {
+      if (q1[(head_+i)%n_] != q2[(mofn.head_+i)%mofn.n_]) {
           return false;
       }
-      ++it1_ptr;
-      ++it2_ptr;
   }
   return true;
 }
 
 std::string MofN::toString() const {
   std::string s=Fmi(m_)+" of "+Fmi(n_)+": [";
-  bool comma = false;
-  for (std::deque<int>::const_iterator val_ptr = queue_.begin(); val_ptr != queue_.end(); ++val_ptr) {
-    if (comma) {
+  const int* q = queue();
+  for (int i=0; i < n_; ++i) {
+    if (i > 0) {
       s+=",";
-    } else {
-      comma = true;
     }
-    s += Fmi(*val_ptr);
+    s += Fmi(q[(head_+i)%n_]);
   }
   s+="]";
   return s;
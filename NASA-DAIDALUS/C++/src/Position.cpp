@@ -79,8 +79,12 @@ Position Position::makeLatLonAlt(double lat, std::string lat_unit, double lon, s
 	return Position(LatLonAlt::make(lat, lat_unit, lon, lon_unit, alt, alt_unit));
 }
 
+Position Position::makeLatLonAlt(double lat, Unit lat_unit, double lon, Unit lon_unit, double alt, Unit alt_unit) {
+	return Position(LatLonAlt::mk(Units::from(lat_unit, lat), Units::from(lon_unit, lon), Units::from(alt_unit, alt)));
+}
+
 Position Position::makeXYZ(double x, double y, double z) {
-	return Position(Units::from("nm", x), Units::from("nm", y), Units::from("ft",z));
+	return Position(Units::from(units::NM, x), Units::from(units::NM, y), Units::from(units::ft,z));
 }
 
 
@@ -93,6 +97,10 @@ Position Position::makeXYZ(double x, std::string x_unit, double y, std::string y
 	return Position(Units::from(x_unit, x), Units::from(y_unit, y), Units::from(z_unit,z));
 }
 
+Position Position::makeXYZ(double x, Unit x_unit, double y, Unit y_unit, double z, Unit z_unit) {
+	return Position(Units::from(x_unit, x), Units::from(y_unit, y), Units::from(z_unit,z));
+}
+
 Position Position::make(const LatLonAlt& lla)
 {
 	return Position(lla);
@@ -194,15 +202,15 @@ double Position::altitude() const {
 }
 
 double Position::xCoordinate() const {
-	return Units::to("nm", s3.x);
+	return Units::to(units::NM, s3.x);
 }
 
 double Position::yCoordinate() const {
-	return Units::to("nm", s3.y);
+	return Units::to(units::NM, s3.y);
 }
 
 double Position::zCoordinate() const {
-	return Units::to("ft", s3.z);
+	return Units::to(units::ft, s3.z);
 }
 
 
@@ -302,7 +310,7 @@ const Position Position::linearEst(double dn, double de) const {
 const Position Position::linearEst(const Velocity& vo, double time) const {
 	Position newNP;
 	if (latlon) {
-		if (lat() > Units::from("deg",85) || lat() < Units::from("deg",-85)) {
+		if (lat() > Units::from(units::deg,85) || lat() < Units::from(units::deg,-85)) {
 			newNP = Position (GreatCircle::linear_initial(ll,vo,time));
 		} else {
 			newNP = Position(lla().linearEst(vo,time));
@@ -89,6 +89,8 @@ SeparatedInput::SeparatedInput(const SeparatedInput& x) :
 	header_str = x.header_str;
 	units_str = x.units_str;
 	units_factor = x.units_factor;
+	default_str = x.default_str;
+	default_factor = x.default_factor;
 	line_str = x.line_str;
 	linenum = x.linenum;
 	patternStr = x.patternStr;
@@ -114,6 +116,8 @@ SeparatedInput& SeparatedInput::operator=(const SeparatedInput& x) {
 	header_str = x.header_str;
 	units_str = x.units_str;
 	units_factor = x.units_factor;
+	default_str = x.default_str;
+	default_factor = x.default_factor;
 	line_str = x.line_str;
 	linenum = x.linenum;
 	patternStr = x.patternStr;
@@ -271,7 +275,8 @@ bool SeparatedInput::getCaseSensitive() const {
 
 double SeparatedInput::getUnitFactor(int i) const {
 	if (!bunits || i < 0 || (unsigned int) i >= units_str.size()) {
-		return Units::getFactor("unspecified");
+		static const double unspecified = Units::getFactor("unspecified");
+		return unspecified;
 	}
 	return units_factor[i];
 }
@@ -314,13 +319,30 @@ double SeparatedInput::getColumn(int i) const {
 
 
 double SeparatedInput::getColumn(int i, const std::string& default_unit) const {
-	if (getUnit(i) == "unspecified") {
-		return Units::from(default_unit, getColumn(i, 0.0, true));
+	if (!bunits || i < 0 || (unsigned int) i >= units_str.size() || units_str[i] == "unspecified") {
+		return Units::from(getDefaultUnitFactor(i, default_unit), getColumn(i, 0.0, true));
 	}
 
 	return getColumn(i, 0.0, true);
 }
 
+// Columns are usually read with the same default unit on every line, so its
+// conversion value is only looked up when the requested unit changes.
+double SeparatedInput::getDefaultUnitFactor(int i, const std::string& default_unit) const {
+	if (i < 0) {
+		return Units::getFactor(default_unit);
+	}
+	if ((unsigned int) i >= default_str.size()) {
+		default_str.resize(i+1);
+		default_factor.resize(i+1, NaN);
+	}
+	if (ISNAN(default_factor[i]) || default_str[i] != default_unit) {
+		default_str[i] = default_unit;
+		default_factor[i] = Units::getFactor(default_unit);
+	}
+	return default_factor[i];
+}
+
 
 
 
@@ -340,12 +362,12 @@ bool SeparatedInput::readLine() {
 
 			str = readFullLine(reader);
 
-			string lineRead = str + "\n";
+			string lineRead = header ? "" : str + "\n"; // only needed for the preamble
 
 			// Remove comments from line
 			size_t comment_num = str.find('#');
 			if (comment_num != string::npos) {   //if (comment_num >= 0) {
-				str = str.substr(0,comment_num);
+				str.erase(comment_num);
 			}
 			trim(str);
 			// Skip empty lines
@@ -505,6 +527,10 @@ bool SeparatedInput::process_units(const string& str) {
 
 void SeparatedInput::process_line(const string& str) {
 	//vector<string> fields = split(str, patternStr);
+	if (!fixed_width && !quoteCharDefined) {
+		split_line(str, line_str);
+		return;
+	}
 	vector<string> fields;
 	if (fixed_width) {
 		unsigned int idx = 0;
@@ -522,14 +548,42 @@ void SeparatedInput::process_line(const string& str) {
 			idx = idx + width_int[i];
 		}
 	} else {
-		std::string str2 = str;
-		if (quoteCharDefined) {
-			fields = processQuotes(str);
-		} else {
-			fields = split_regex(str2, patternStr);
+		fields = processQuotes(str);
+	}
+	line_str.swap(fields);
+}
+
+// Split str into fields. For the default delimiters, this is the same as split_regex,
+// but fields are scanned directly and the strings already in fields are reused.
+void SeparatedInput::split_line(const string& str, vector<string>& fields) const {
+	if (patternStr != Constants::wsPatternBase) {
+		fields = split_regex(str, patternStr);
+		return;
+	}
+	const string& delims = Constants::wsPatternBaseNoRegex;
+	size_t n = 0;
+	size_t start = 0;
+	while (start < str.size()) {
+		if (n == fields.size()) {
+			fields.push_back("");
+		}
+		size_t end = str.find_first_of(delims, start);
+		if (end == string::npos) {
+			fields[n++].assign(str, start, string::npos);
+			break;
+		}
+		fields[n++].assign(str, start, end-start);
+		start = str.find_first_not_of(delims, end);
+		if (start == string::npos) {
+			// Line ends with delimiters
+			if (n == fields.size()) {
+				fields.push_back("");
+			}
+			fields[n++].clear();
+			break;
 		}
 	}
-	line_str = fields;
+	fields.resize(n);
 }
 
 vector<string> SeparatedInput::processQuotes(const string& str) const {
@@ -118,6 +118,21 @@ void TrafficState::setAsIntruderOf(const TrafficState& ownship) {
   }
 }
 
+/**
+ * Set position to new_pos and ground velocity to new_gvel, keeping the wind vector, and set
+ * aircraft as intruder of ownship. Identifier, alerter, and SUM data are kept.
+ */
+void TrafficState::setStateAsIntruderOf(const Position& new_pos, const Velocity& new_gvel, const TrafficState& ownship) {
+  Velocity wind = windVector();
+  pos_ = new_pos;
+  gvel_ = new_gvel;
+  avel_ = Velocity(new_gvel.Sub(wind));
+  if (isLatLon() && ownship.isLatLon()) {
+    eprj_ = ownship.getEuclideanProjection();
+  }
+  applyEuclideanProjection();
+}
+
 TrafficState TrafficState::makeIntruder(const std::string& id, const Position& pos, const Velocity& vel) const {
   if (pos_.isLatLon() != pos.isLatLon()) {
     return INVALID();
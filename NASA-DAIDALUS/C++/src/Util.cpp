@@ -15,6 +15,8 @@
 #include "Units.h"
 #include "Constants.h"
 #include <cmath>
+#include <cerrno>
+#include <cstdlib>
 #include <limits>
 #include <string.h>
 #include "format.h"
@@ -486,6 +488,17 @@ bool Util::is_double(const string& str) {
 #endif
 
 double Util::parse_double(const string& str) {
+	// Plain decimal numbers, which are most numbers in data files, are converted directly.
+	// Anything else, e.g., surrounding spaces or trailing characters, is left to the stream.
+	if (!str.empty() && str.find_first_not_of("0123456789+-.eE") == string::npos) {
+		const char* begin = str.c_str();
+		char* end;
+		errno = 0;
+		double d = strtod(begin,&end);
+		if (end == begin+str.size() && errno == 0) {
+			return d;
+		}
+	}
 	std::istringstream stream;
 	stream.str(str);
 	double d;
@@ -46,7 +46,7 @@ Velocity Velocity::mkVxyz(const double vx, const double vy, const double vz) {
 
 
 Velocity Velocity::makeVxyz(const double vx, const double vy, const double vz) {
-	return Velocity(Units::from("kn",vx),Units::from("kn",vy),Units::from("fpm",vz));
+	return Velocity(Units::from(units::kn,vx),Units::from(units::kn,vy),Units::from(units::fpm,vz));
 }
 
 
@@ -55,12 +55,17 @@ Velocity Velocity::makeVxyz(const double vx, const double vy, const std::string&
 	return Velocity(Units::from(uvxy,vx),Units::from(uvxy, vy), Units::from(uvz,vz));
 }
 
+Velocity Velocity::makeVxyz(const double vx, const double vy, const Unit uvxy,
+		const double vz, const Unit uvz) {
+	return Velocity(Units::from(uvxy,vx),Units::from(uvxy, vy), Units::from(uvz,vz));
+}
+
 Velocity Velocity::mkTrkGsVs(const double trk, const double gs, const double vs){
 	return Velocity(trkgs2vx(trk,gs),trkgs2vy(trk,gs),vs);
 }
 
 Velocity Velocity::makeTrkGsVs(const double trk, const double gs, const double vs) {
-	return Velocity::mkTrkGsVs(Units::from("deg",trk), Units::from("kn",gs),Units::from("fpm",vs));
+	return Velocity::mkTrkGsVs(Units::from(units::deg,trk), Units::from(units::kn,gs),Units::from(units::fpm,vs));
 }
 
 
@@ -70,6 +75,12 @@ Velocity Velocity::makeTrkGsVs(const double trk, const std::string& utrk,
 	return mkTrkGsVs(Units::from(utrk,trk), Units::from(ugs,gs),Units::from(uvs,vs));
 }
 
+Velocity Velocity::makeTrkGsVs(const double trk, const Unit utrk,
+		const double gs, const Unit ugs,
+		const double vs, const Unit uvs) {
+	return mkTrkGsVs(Units::from(utrk,trk), Units::from(ugs,gs),Units::from(uvs,vs));
+}
+
 
 Velocity Velocity::mkVel(const Vect3& p1,const Vect3& p2, double speed) {
 	Velocity rtn = make(p2.Sub(p1).Hat().Scal(speed));
@@ -12,6 +12,9 @@
 #include "Vect3.h"
 #include "Velocity.h"
 #include "Horizontal.h"
+#include "CriticalVectors2D.h"
+#include "TangentLine.h"
+#include "Interval.h"
 #include "WCVTable.h"
 #include "LossData.h"
 #include "Util.h"
@@ -133,6 +136,40 @@ LossData WCV_TAUMOD::horizontal_WCV_interval(double T, const Vect2& s, const Vec
   return LossData(time_in,time_out);
 }
 
+// The horizontal conflict status changes when the relative position at the beginning of the vertical interval
+// crosses the DTHR circle or stops approaching, when the modified tau at the end of the vertical interval
+// reaches TTHR, or when the horizontal miss distance reaches DTHR.
+bool WCV_TAUMOD::horizontalCriticalTracks(std::vector<double>& trks, const Vect3& so, const Velocity& co, double r, const Vect3& si, const Velocity& vi,
+    double B, double T) const {
+  Vect3 s = so.Sub(si);
+  Interval ii = wcv_vertical->vertical_WCV_interval(table.getZTHR(),table.getTCOA(),B,T,s.z,co.z-vi.z);
+  if (ii.low > ii.up) {
+    return true;
+  }
+  if (Util::almost_equals(ii.low,ii.up)) {
+    return false;
+  }
+  Vect2 s2 = s.vect2();
+  Vect2 w = co.vect2().Sub(vi.vect2());
+  double c = s2.sqv()-Util::sq(table.getDTHR());
+  double t = ii.low;
+  CriticalVectors2D::circleTracks(trks,w,r,Util::sq(t),s2.Scal(2*t),c);
+  CriticalVectors2D::circleTracks(trks,w,r,t,s2,0);
+  t = ii.up;
+  CriticalVectors2D::circleTracks(trks,w,r,t*(t+table.getTTHR()),s2.Scal(2*t+table.getTTHR()),c);
+  if (Horizontal::horizontal_sep(s2,table.getDTHR())) {
+    for (int eps=-1;eps <= 1; eps+=2) {
+      TangentLine nv(s2,table.getDTHR(),eps);
+      CriticalVectors2D::circleTracks(trks,w,r,0,nv.PerpR(),0);
+    }
+  }
+  // Zero relative velocity
+  if (!w.isZero()) {
+    trks.push_back(w.Neg().compassAngle());
+  }
+  return true;
+}
+
 Detection3D* WCV_TAUMOD::make() const {
   return new WCV_TAUMOD();
 }
@@ -13,6 +13,7 @@
 #include "format.h"
 #include "string_util.h"
 #include <math.h>
+#include <cmath>
 
 namespace larcfm {
 
@@ -165,22 +166,35 @@ std::pair<Vect2,Vect2> WCV_TAUMOD_SUM::optimal_pair(const Vect2& v1, const Vect2
   }
 }
 
-std::pair<Vect2,Vect2> WCV_TAUMOD_SUM::optimal_wcv_pair_comp_init(const Vect2& s, const Vect2& v, double s_err, double v_err) const {
+std::pair<Vect2,Vect2> WCV_TAUMOD_SUM::position_tangents(const Vect2& s, double s_err) const {
   Vect2 v1 = TangentLine(s,s_err,-1);
   v1 = v1.Hat();
   Vect2 v2 = TangentLine(s,s_err,1);
   v2 = v2.Hat();
+  return std::pair<Vect2,Vect2>(v1,v2);
+}
+
+std::pair<Vect2,Vect2> WCV_TAUMOD_SUM::optimal_wcv_pair_comp_init(const Vect2& s, const Vect2& v, double s_err, double v_err) const {
+  return optimal_wcv_pair_comp_init(position_tangents(s,s_err),v,v_err);
+}
+
+std::pair<Vect2,Vect2> WCV_TAUMOD_SUM::optimal_wcv_pair_comp_init(const std::pair<Vect2,Vect2>& s_tangents, const Vect2& v, double v_err) const {
   Vect2 w = v.Neg();
   Vect2 w1 = TangentLine(w,v_err,-1);
   w1 = w1.Hat();
   Vect2 w2 = TangentLine(w,v_err,1);
   w2 = w2.Hat();
-  std::pair<Vect2,Vect2> op = optimal_pair(v1,v2,w1,w2);
+  std::pair<Vect2,Vect2> op = optimal_pair(s_tangents.first,s_tangents.second,w1,w2);
   return std::pair<Vect2,Vect2>(op.first.Neg(),op.second);
 }
 
 std::pair<Vect2,Vect2> WCV_TAUMOD_SUM::optimal_wcv_pair(const Vect2& s, const Vect2& v, double s_err, double v_err, int eps1, int eps2) const {
-  std::pair<Vect2,Vect2> owpci = optimal_wcv_pair_comp_init(s,v,s_err,v_err);
+  return optimal_wcv_pair(position_tangents(s,s_err),s,v,s_err,v_err,eps1,eps2);
+}
+
+std::pair<Vect2,Vect2> WCV_TAUMOD_SUM::optimal_wcv_pair(const std::pair<Vect2,Vect2>& s_tangents, const Vect2& s, const Vect2& v,
+    double s_err, double v_err, int eps1, int eps2) const {
+  std::pair<Vect2,Vect2> owpci = optimal_wcv_pair_comp_init(s_tangents,v,v_err);
   return std::pair<Vect2,Vect2>(owpci.first.Scal(s.norm()+eps1*s_err),owpci.second.Scal(v.norm()-eps2*v_err));
 }
 
@@ -211,7 +225,8 @@ bool WCV_TAUMOD_SUM::WCV_taumod_uncertain(const Vect3& s, const Vect3& v, double
       vertical_WCV_uncertain(s.z,v.z,sz_err,vz_err);
 }
 
-double WCV_TAUMOD_SUM::horizontal_wcv_taumod_uncertain_entry(const Vect2& s, const Vect2& v, double s_err, double v_err, double T) const {
+double WCV_TAUMOD_SUM::horizontal_wcv_taumod_uncertain_entry(const Vect2& s, const Vect2& v, double s_err, double v_err, double T,
+    const std::pair<Vect2,Vect2>* s_tangents) const {
   if (horizontal_WCV(s,v) || s.sqv()<=Util::sq(table.DTHR+s_err)) {
     return 0;
   }
@@ -224,7 +239,8 @@ double WCV_TAUMOD_SUM::horizontal_wcv_taumod_uncertain_entry(const Vect2& s, con
       return ee.getTimeIn();
     }
   } else {
-    std::pair<Vect2,Vect2> op = optimal_wcv_pair(s,v,s_err,v_err,-1,-1);
+    std::pair<Vect2,Vect2> op = s_tangents != NULL ? optimal_wcv_pair(*s_tangents,s,v,s_err,v_err,-1,-1) :
+        optimal_wcv_pair(s,v,s_err,v_err,-1,-1);
     if (op.first.dot(op.second) < 0) {
       return  Util::min(horizontal_WCV_interval(T,s,v).getTimeIn(),
           horizontal_WCV_interval(T,op.first,op.second).getTimeIn());
@@ -263,8 +279,9 @@ double WCV_TAUMOD_SUM::horizontal_wcv_taumod_uncertain_exit(const Vect2& s, cons
   }
 }
 
-LossData WCV_TAUMOD_SUM::horizontal_wcv_taumod_uncertain_interval(const Vect2& s, const Vect2& v,double s_err, double v_err, double T) const {
-  double entrytime = horizontal_wcv_taumod_uncertain_entry(s,v,s_err,v_err,T);
+LossData WCV_TAUMOD_SUM::horizontal_wcv_taumod_uncertain_interval(const Vect2& s, const Vect2& v,double s_err, double v_err, double T,
+    const std::pair<Vect2,Vect2>* s_tangents) const {
+  double entrytime = horizontal_wcv_taumod_uncertain_entry(s,v,s_err,v_err,T,s_tangents);
   double exittime = horizontal_wcv_taumod_uncertain_exit(s,v,s_err,v_err,T);
   if (entrytime > T || exittime < 0 || entrytime > exittime) {
     return LossData();
@@ -329,10 +346,15 @@ LossData WCV_TAUMOD_SUM::vertical_WCV_uncertain_interval(double B, double T, dou
 LossData WCV_TAUMOD_SUM::WCV_taumod_uncertain_interval(double B, double T, const Vect3& s, const Vect3& v,
     double s_err, double sz_err, double v_err, double vz_err) const {
   LossData vint = vertical_WCV_uncertain_interval(B,T,s.z,v.z,sz_err,vz_err);
+  return WCV_taumod_uncertain_interval(vint,B,T,s.vect2(),v.vect2(),s_err,v_err,NULL);
+}
+
+LossData WCV_TAUMOD_SUM::WCV_taumod_uncertain_interval(const LossData& vint, double B, double T, const Vect2& s, const Vect2& v,
+    double s_err, double v_err, const std::pair<Vect2,Vect2>* s_tangents) const {
   if (vint.getTimeIn() > vint.getTimeOut()) {
     return vint; // Empty interval
   }
-  LossData hint = horizontal_wcv_taumod_uncertain_interval(s.vect2(),v.vect2(),s_err,v_err,T);
+  LossData hint = horizontal_wcv_taumod_uncertain_interval(s,v,s_err,v_err,T,s_tangents);
   if (hint.getTimeIn() > hint.getTimeOut()) {
     return hint; // Empty interval
   }
@@ -394,6 +416,65 @@ ConflictData WCV_TAUMOD_SUM::conflictDetectionWithTrafficState(const TrafficStat
   return ConflictData(ld,t_tca,dist_tca,s,v);
 }
 
+/**
+ * Batched version of conflictDetectionWithTrafficState for ownship states that only differ in their
+ * velocities. Uncertainty terms, relative position, and tangent directions of the position uncertainty
+ * are computed once. The vertical interval of violation is computed once for consecutive states with the
+ * same vertical speed. Results are the same as calling conflictDetectionWithTrafficState for each state.
+ */
+void WCV_TAUMOD_SUM::conflictDetectionWithTrafficStates(std::vector<ConflictData>& dets, const std::vector<TrafficState>& owns,
+    const TrafficState& intruder, double B, double T) const {
+  if (owns.empty()) {
+    dets.clear();
+    return;
+  }
+  const TrafficState& own = owns[0];
+  double s_err = relativeHorizontalPositionError(own,intruder);
+  double sz_err = relativeVerticalPositionError(own,intruder);
+  double v_err = relativeHorizontalSpeedError(own,intruder,s_err);
+  double vz_err = relativeVerticalSpeedError(own,intruder);
+
+  if (s_err == 0.0 && sz_err == 0.0 && v_err == 0.0 && vz_err == 0.0) {
+    Detection3D::conflictDetectionWithTrafficStates(dets,owns,intruder,B,T);
+    return;
+  }
+
+  s_err = Util::max(s_err, MinError);
+  sz_err = Util::max(sz_err, MinError);
+  v_err = Util::max(v_err, MinError);
+  vz_err = Util::max(vz_err, MinError);
+
+  dets.clear();
+  dets.reserve(owns.size());
+  Vect3 s = own.get_s().Sub(intruder.get_s());
+  Vect2 s2 = s.vect2();
+  Velocity vi = intruder.get_v();
+  std::pair<Vect2,Vect2> s_tangents = position_tangents(s2,s_err);
+  LossData vint;
+  double vint_vz = NaN;
+  for (std::vector<TrafficState>::const_iterator own_ptr = owns.begin(); own_ptr != owns.end(); ++own_ptr) {
+    Vect3 v = own_ptr->get_v().Sub(vi);
+    // Signed zeros are distinguished since they may yield different vertical intervals
+    if (!(v.z == vint_vz && std::signbit(v.z) == std::signbit(vint_vz))) {
+      vint = vertical_WCV_uncertain_interval(B,T,s.z,v.z,sz_err,vz_err);
+      vint_vz = v.z;
+    }
+    LossData ld = WCV_taumod_uncertain_interval(vint,B,T,s2,v.vect2(),s_err,v_err,&s_tangents);
+    double t_tca = (ld.getTimeIn() + ld.getTimeOut())/2.0;
+    double dist_tca = s.linear(v, t_tca).cyl_norm(table.DTHR,table.ZTHR);
+    dets.push_back(ConflictData(ld,t_tca,dist_tca,s,v));
+  }
+}
+
+bool WCV_TAUMOD_SUM::horizontalCriticalTracks(std::vector<double>& trks, const Vect3& so, const Velocity& co, double r, const Vect3& si, const Velocity& vi,
+    double B, double T) const {
+  return false;
+}
+
+double WCV_TAUMOD_SUM::horizontalViolationRange(double vh) const {
+  return PINFINITY;
+}
+
 Detection3D* WCV_TAUMOD_SUM::make() const {
   return new WCV_TAUMOD_SUM();
 }
@@ -17,6 +17,7 @@
 #include "format.h"
 #include "string_util.h"
 #include <cfloat>
+#include <cmath>
 
 namespace larcfm {
 
@@ -119,15 +120,45 @@ ConflictData WCV_tvar::conflictDetection(const Vect3& so, const Velocity& vo, co
   return ConflictData(ret, t_tca,dist_tca,so.Sub(si),vo.Sub(vi));
 }
 
+/**
+ * Batched conflict detection for a list of ownship velocities. The vertical interval of violation
+ * is computed once for consecutive velocities with the same vertical speed. Results are the same as
+ * calling conflictDetection for each velocity.
+ */
+void WCV_tvar::conflictDetectionVelocities(std::vector<ConflictData>& dets, const Vect3& so, const std::vector<Velocity>& vos,
+    const Vect3& si, const Velocity& vi, double B, double T) const {
+  dets.clear();
+  dets.reserve(vos.size());
+  double DTHR = table.getDTHR();
+  double ZTHR = table.getZTHR();
+  double TCOA = table.getTCOA();
+  Vect3 s = so.Sub(si);
+  Vect2 s2 = so.vect2().Sub(si.vect2());
+  Vect2 vi2 = vi.vect2();
+  double sz = so.z-si.z;
+  Interval ii;
+  double ii_vz = NaN;
+  for (std::vector<Velocity>::const_iterator vo_ptr = vos.begin(); vo_ptr != vos.end(); ++vo_ptr) {
+    const Velocity& vo = *vo_ptr;
+    double vz = vo.z-vi.z;
+    // Signed zeros are distinguished since they may yield different vertical intervals
+    if (!(vz == ii_vz && std::signbit(vz) == std::signbit(ii_vz))) {
+      ii = wcv_vertical->vertical_WCV_interval(ZTHR,TCOA,B,T,sz,vz);
+      ii_vz = vz;
+    }
+    LossData ret = WCV_interval(ii,s2,vo.vect2().Sub(vi2),B,T);
+    double t_tca = (ret.getTimeIn() + ret.getTimeOut())/2;
+    double dist_tca = so.linear(vo, t_tca).Sub(si.linear(vi, t_tca)).cyl_norm(DTHR,ZTHR);
+    dets.push_back(ConflictData(ret,t_tca,dist_tca,s,vo.Sub(vi)));
+  }
+}
+
 LossData WCV_tvar::WCV3D(const Vect3& so, const Velocity& vo, const Vect3& si, const Velocity& vi, double B, double T) const {
   return WCV_interval(so,vo,si,vi,B,T);
 }
 
 // Assumes 0 <= B < T
 LossData WCV_tvar::WCV_interval(const Vect3& so, const Velocity& vo, const Vect3& si, const Velocity& vi, double B, double T) const {
-  double time_in = T;
-  double time_out = B;
-
   Vect2 so2 = so.vect2();
   Vect2 si2 = si.vect2();
   Vect2 s2 = so2.Sub(si2);
@@ -138,6 +169,12 @@ LossData WCV_tvar::WCV_interval(const Vect3& so, const Velocity& vo, const Vect3
   double vz = vo.z-vi.z;
 
   Interval ii = wcv_vertical->vertical_WCV_interval(table.getZTHR(),table.getTCOA(),B,T,sz,vz);
+  return WCV_interval(ii,s2,v2,B,T);
+}
+
+LossData WCV_tvar::WCV_interval(const Interval& ii, const Vect2& s2, const Vect2& v2, double B, double T) const {
+  double time_in = T;
+  double time_out = B;
 
   if (ii.low > ii.up) {
     return LossData(time_in,time_out);
@@ -156,6 +193,10 @@ LossData WCV_tvar::WCV_interval(const Vect3& so, const Velocity& vo, const Vect3
   return LossData(time_in,time_out);
 }
 
+double WCV_tvar::horizontalViolationRange(double vh) const {
+  return table.getDTHR()+table.getTTHR()*vh;
+}
+
 bool WCV_tvar::containsTable(WCV_tvar* wcv) const {
   return table.contains(wcv->table);
 }
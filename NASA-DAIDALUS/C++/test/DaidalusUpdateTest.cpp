@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2015-2021 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+/*
+ * DaidalusUpdateTest.cpp
+ *
+ * Checks that the incremental interface of Daidalus, i.e., updateOwnshipState and
+ * updateTrafficState, keeps ownship and traffic positions of the same kind, lat/lon or
+ * Euclidean, as setOwnshipState and addTrafficState do. Exit status is the number of
+ * failed checks.
+ */
+
+#include "Daidalus.h"
+#include <iostream>
+#include <string>
+
+using namespace larcfm;
+
+static int failures = 0;
+
+static void check(bool cond, const std::string& msg) {
+  if (!cond) {
+    std::cout << "FAILED: " << msg << std::endl;
+    ++failures;
+  }
+}
+
+int main() {
+  Daidalus daa;
+  daa.set_DO_365B();
+
+  Position own_ll = Position::makeLatLonAlt(33.95,"deg",-96.7,"deg",8700.0,"ft");
+  Velocity own_v = Velocity::makeTrkGsVs(206.0,"deg",151.0,"knot",0.0,"fpm");
+  Position ll = Position::makeLatLonAlt(33.86,"deg",-96.73,"deg",9000.0,"ft");
+  Velocity ll_v = Velocity::makeTrkGsVs(0.0,"deg",210.0,"knot",0.0,"fpm");
+  Position own_xyz = Position::makeXYZ(0.0,"NM",0.0,"NM",8700.0,"ft");
+  Position xyz = Position::makeXYZ(1.0,"NM",-5.0,"NM",9000.0,"ft");
+
+  // Lat/lon ownship rejects Euclidean traffic
+  daa.setOwnshipState("ownship",own_ll,own_v,0.0);
+  check(daa.addTrafficState("ll",ll,ll_v) == 1, "lat/lon traffic is added to lat/lon ownship");
+  check(daa.addTrafficState("xyz",xyz,ll_v) < 0, "Euclidean traffic is rejected by lat/lon ownship");
+  check(!daa.updateTrafficState(1,xyz,ll_v), "lat/lon traffic is not updated with Euclidean state");
+  check(daa.lastTrafficIndex() == 1, "lat/lon ownship has one traffic aircraft");
+
+  // Euclidean ownship drops lat/lon traffic that was kept by the incremental update
+  daa.updateOwnshipState("ownship",own_xyz,own_v,1.0);
+  check(!daa.getOwnshipState().isLatLon(), "ownship is Euclidean after update");
+  check(daa.lastTrafficIndex() == 0, "lat/lon traffic is removed when ownship becomes Euclidean");
+  check(daa.aircraftIndex("ll") < 0, "lat/lon traffic is not found after ownship becomes Euclidean");
+  check(daa.addTrafficState("xyz",xyz,ll_v) == 1, "Euclidean traffic is added to Euclidean ownship");
+  check(daa.alertLevel(1) >= 0, "alerting is computed for Euclidean traffic");
+
+  // Alerting is the same as when states are set from scratch
+  Daidalus ref = daa;
+  ref.setOwnshipState("ownship",own_xyz,own_v,1.0);
+  ref.addTrafficState("xyz",xyz,ll_v);
+  check(daa.alertLevel(1) == ref.alertLevel(1), "alerting is the same as with setOwnshipState");
+
+  // Lat/lon ownship drops Euclidean traffic
+  daa.updateOwnshipState("ownship",own_ll,own_v,2.0);
+  check(daa.getOwnshipState().isLatLon(), "ownship is lat/lon after update");
+  check(daa.lastTrafficIndex() == 0, "Euclidean traffic is removed when ownship becomes lat/lon");
+  check(daa.addTrafficState("ll",ll,ll_v,2.0) == 1, "lat/lon traffic is added again");
+
+  // Traffic of the same kind is kept
+  daa.updateOwnshipState("ownship",own_ll.linear(own_v,1.0),own_v,3.0);
+  check(daa.lastTrafficIndex() == 1 && daa.aircraftIndex("ll") == 1, "lat/lon traffic is kept by lat/lon ownship");
+  check(daa.alertLevel(1) >= 0, "alerting is computed for kept traffic");
+
+  if (failures == 0) {
+    std::cout << "All checks passed" << std::endl;
+  }
+  return failures;
+}
@@ -4,7 +4,9 @@
 #include "vrfLua/luaObjectSerializer.h"
 #include "vrfobjcore/localObject.h"
 #include "luabind/out_value_policy.hpp"
+#include "luabind/object.hpp"
 #include "NASA-DAIDALUS/C++/include/Daidalus.h"
+#include "NASA-DAIDALUS/C++/include/DaidalusFleet.h"
 
 
 //! This class will be used to bind Lua functions to.  The example is provided for
@@ -14,7 +16,8 @@ class DaidalusCEI : public DtLuaScriptInterfaceExtension
 
 public:
 	DaidalusCEI() : daa(), bConfigFileFound(false) {
-		if (daa.loadFromFile("daidalus_params.conf")) {
+		// The configuration file is parsed once and shared by all entities
+		if (daa.loadSharedFromFile("daidalus_params.conf")) {
 			// Default configuration parameters
 			bConfigFileFound = true;
 		}
@@ -40,10 +43,20 @@ public:
 
 	virtual void isDirectionInConflict(double& result, double direction, double time);
 
+	virtual luabind::object getDirectionConflicts(lua_State* L, const luabind::object& directions);
+
+	virtual luabind::object sweepDirectionConflicts(lua_State* L, double min_dir, double max_dir, double step);
+
 	virtual void setOwnshipState(std::string ido, double lat, double lon, double alt, double vx, double vy, double vz, double to);
 
 	virtual void addTrafficState(int& aci_idx, std::string idi, double lat, double lon, double alt, double vx, double vy, double vz, double to);
 
+	virtual void updateOwnshipState(std::string ido, double lat, double lon, double alt, double vx, double vy, double vz, double to);
+
+	virtual void updateTrafficState(int& aci_idx, std::string idi, double lat, double lon, double alt, double vx, double vy, double vz, double to);
+
+	virtual void removeStaleTraffic(int& removed, double max_age);
+
 	virtual void getDetectionTime(double& time_to_violation, int ac_idx);
 
 	inline virtual void setWindVelocityTo(double vx, double vy, double vz) {
@@ -112,13 +125,13 @@ public:
 
 			larcfm::Vect3 s = daa.getCore().ownship.get_s() - daa.getAircraftStateAt(idx).get_s();
 
-			closure_rate = s.vect2().dot(v.vect2()) < 0 ? -daa.horizontalClosureRate(idx, "m") : daa.horizontalClosureRate(idx, "m");
+			closure_rate = s.vect2().dot(v.vect2()) < 0 ? -daa.horizontalClosureRate(idx, larcfm::units::mps) : daa.horizontalClosureRate(idx, larcfm::units::mps);
 
 
 		}
 		else
 		{
-			closure_rate = daa.verticalClosureRate(idx, "m");
+			closure_rate = daa.verticalClosureRate(idx, larcfm::units::mps);
 		}
 
 	}
@@ -155,7 +168,7 @@ public:
 
 	inline virtual void getHMD(double& hmd, int idx)
 	{
-		hmd = daa.predictedHorizontalMissDistance(idx, "m");
+		hmd = daa.predictedHorizontalMissDistance(idx, larcfm::units::m);
 	}
 
 	inline virtual void getModifiedTau(double& tau, double DMOD, int idx)
@@ -177,11 +190,72 @@ public:
 
 	virtual void getHorizontalDirectionBands();
 
+	//! Enables or disables concurrent computation of bands in the four dimensions. The thread pool is
+	//! shared by all DAIDALUS objects in the simulation, so the number of threads only needs to be set once.
+	inline virtual void setParallelBands(bool enabled, int threads)
+	{
+		if (larcfm::DaidalusThreadPool::shared().getNumberOfThreads() != threads) {
+			larcfm::DaidalusThreadPool::shared().setNumberOfThreads(threads);
+		}
+		daa.setParallelBands(enabled);
+	}
 
+	//! Computes bands in all dimensions for the current states, e.g., before querying all guidance
+	inline virtual void refreshBands()
+	{
+		daa.refreshBands();
+	}
 
 
 
 
+
+
+	//! The fleet is shared by all entities in the simulation. Every entity sets its own state, then one of
+	//! them computes alerting and bands for all ownships of the fleet once per time step. Unless
+	//! setFleetConfiguration is called, the fleet uses the configuration of the first entity that accesses it.
+	larcfm::DaidalusFleet& fleet();
+
+	//! Sets configuration of all ownships of the fleet to the one of this entity. Hysteresis of the fleet is cleared
+	inline virtual void setFleetConfiguration()
+	{
+		fleet().setConfiguration(daa);
+	}
+
+	virtual void setFleetAircraftState(std::string id, double lat, double lon, double alt, double vx, double vy, double vz, double t, bool ownship);
+
+	inline virtual void removeFleetAircraft(bool& removed, std::string id)
+	{
+		removed = fleet().removeAircraft(id);
+	}
+
+	inline virtual void computeFleet()
+	{
+		fleet().compute();
+	}
+
+	inline virtual void getFleetAlertLevel(int& alert_level, std::string id)
+	{
+		alert_level = fleet().getSummary(id).alert_level;
+	}
+
+	inline virtual void getFleetDetectionTime(double& time_to_violation, std::string id)
+	{
+		time_to_violation = fleet().getSummary(id).time_to_corrective_volume;
+	}
+
+	virtual void getFleetResolutionDirection(double& trackOrHeading, std::string id, bool is_right);
+
+	inline virtual void getFleetTime2CPA(double& tcpa, std::string id1, std::string id2)
+	{
+		tcpa = fleet().timeToHorizontalClosestPointOfApproach(id1, id2);
+	}
+
+	inline virtual void getFleetHMD(double& hmd, std::string id1, std::string id2)
+	{
+		hmd = fleet().predictedHorizontalMissDistance(id1, id2);
+	}
+
 	virtual void printMessage(const std::string& message);
 
 
@@ -189,6 +263,10 @@ public:
 
 	bool alreadyInitialized(lua_State* L, const char* moduleName) const;
 
+	//! Evaluates all directions (in degrees) in one batched what-if query and returns a Lua array
+	//! with one table {direction, timeToViolation, tcpa} per direction
+	luabind::object directionConflictsTable(lua_State* L, const std::vector<double>& directions);
+
 	virtual void reloadConfig(bool& ret);
 
 	//! Binds method for this class to the lua state.  This simple method will
@@ -95,12 +95,12 @@ function tick()
       --daidalus:luaExamplePrintMessage(""..i..","..k[1])
    end
    
-   -- Add this object to ownship
+   -- Update ownship, keeping traffic states (and their hysteresis) from previous ticks
    local loc3d = this:getLocation3D()
    local vel = this:getVelocity3D()
    local time = vrf:getSimulationTime()
    
-   daidalus:setOwnshipState(this:getName(), loc3d:getLat(), loc3d:getLon(), loc3d:getAlt(), vel:getEast(), vel:getNorth(), -vel:getDown(), time)
+   daidalus:updateOwnshipState(this:getName(), loc3d:getLat(), loc3d:getLon(), loc3d:getAlt(), vel:getEast(), vel:getNorth(), -vel:getDown(), time)
    
    local objs = vrf:getVrfObjects()
  
@@ -112,13 +112,16 @@ function tick()
          if type == "2" and this:getUUID() ~= obj:getUUID() then
             local loc3d_obj = obj:getLocation3D()
             local vel_obj = obj:getVelocity3D()
-            local id = daidalus:addTrafficState(obj:getName(), loc3d_obj:getLat(), loc3d_obj:getLon(), loc3d_obj:getAlt(), vel_obj:getEast(), vel_obj:getNorth(), -vel_obj:getDown(), -1)  
+            local id = daidalus:updateTrafficState(obj:getName(), loc3d_obj:getLat(), loc3d_obj:getLon(), loc3d_obj:getAlt(), vel_obj:getEast(), vel_obj:getNorth(), -vel_obj:getDown(), -1)  
             end
       
       end
 
    end
    
+   -- Drop aircraft that were not refreshed in this tick (e.g., removed from the simulation)
+   local removed = daidalus:removeStaleTraffic(1.0)
+   
    -- print time to conflict for every aircraft
    local aircraftNo = daidalus:numberOfAircraft()
    for i, obj in ipairs(objs) do
@@ -5,54 +5,74 @@
 
 //VR-Forces includes
 #include "VRF-DAIDALUS-CEI/DaidalusCEI.h"
+#include <cmath>
 
 
 
 void DaidalusCEI::isDirectionInConflict(double& result, double direction, double time /* direction in degrees */)
 {
-	// We must set the previous direction to the ownship, add all the trafic for that state, then clean-up to the original state
-	larcfm::Position pos = daa.getOwnshipState().getPosition();
-	larcfm::Velocity vel = daa.getOwnshipState().getVelocity();
-	double gs = vel.groundSpeed("knot");
-	larcfm::Velocity vel_conflict = larcfm::Velocity::makeTrkGsVs(direction, gs, 0);
-
-	// Save all traffic
-	std::vector<larcfm::TrafficState> states;
-	for (int i = 1; i < daa.numberOfAircraft(); i++) {
-		if (daa.getAircraftStateAt(i).isValid()) {
-			larcfm::TrafficState ts;
-			memcpy(&ts, &daa.getAircraftStateAt(i), sizeof(larcfm::TrafficState));
-			states.push_back(ts);
-		}
-	}
-	std::string ido(daa.getOwnshipState().getId());
-	// Clear traffic by adding new ownship position
-	daa.setOwnshipState(ido, pos, vel_conflict, time);
+	// Evaluate a hypothetical ownship flying the given direction against the current traffic.
+	// What-if queries don't modify the traffic list, the cached values, or the hysteresis of daa.
+	std::vector<double> tin, tcpa;
+	double gs = daa.getOwnshipState().getVelocity().gs();
+	daa.horizontalDirectionConflicts(tin, tcpa, larcfm::Velocity::mkTrkGsVs(0.0, gs, 0.0),
+		std::vector<double>(1, larcfm::Units::from(larcfm::units::deg, direction)));
+
+	// Minimum time to CPA among aircraft in conflict, MAXDOUBLE if this direction is conflict free.
+	result = tcpa[0] != PINFINITY ? tcpa[0] : MAXDOUBLE;
+}
 
-	// Add back all traffic 
-	for (auto i : states) {
-		daa.addTrafficState(i.getId(), i.getPosition(), i.getVelocity());
+luabind::object DaidalusCEI::directionConflictsTable(lua_State* L, const std::vector<double>& directions)
+{
+	std::vector<double> dirs_rad, tin, tcpa;
+	for (auto dir : directions) {
+		dirs_rad.push_back(larcfm::Units::from(larcfm::units::deg, dir));
 	}
-	
-	// Now, check if this direction has a conflict. 
-
-	double time_to_violation;
-	double result_temp = MAXDOUBLE;
-	for (int i = 1; i < daa.numberOfAircraft(); i++) {
-		getDetectionTime(time_to_violation, i);
-		if (time_to_violation != PINFINITY) {
-			result_temp = daa.timeToHorizontalClosestPointOfApproach(i) <= result_temp ? daa.timeToHorizontalClosestPointOfApproach(i) : result_temp;
-		}
+	double gs = daa.getOwnshipState().getVelocity().gs();
+	daa.horizontalDirectionConflicts(tin, tcpa, larcfm::Velocity::mkTrkGsVs(0.0, gs, 0.0), dirs_rad);
+
+	// Same conventions as getDetectionTime and isDirectionInConflict for conflict free directions
+	luabind::object results = luabind::newtable(L);
+	for (size_t k = 0; k < directions.size(); k++) {
+		luabind::object entry = luabind::newtable(L);
+		entry["direction"] = directions[k];
+		entry["timeToViolation"] = tin[k];
+		entry["tcpa"] = tcpa[k] != PINFINITY ? tcpa[k] : MAXDOUBLE;
+		results[k + 1] = entry;
 	}
-	result = result_temp;
-
-	// Now, set the original state back.
+	return results;
+}
 
-	daa.setOwnshipState(ido, pos, vel, time);
+luabind::object DaidalusCEI::getDirectionConflicts(lua_State* L, const luabind::object& directions)
+{
+	std::vector<double> dirs;
+	if (luabind::type(directions) == LUA_TTABLE) {
+		for (luabind::iterator it(directions), end; it != end; ++it) {
+			dirs.push_back(luabind::object_cast<double>(*it));
+		}
+	}
+	return directionConflictsTable(L, dirs);
+}
 
-	for (auto i : states) {
-		daa.addTrafficState(i.getId(), i.getPosition(), i.getVelocity());
+luabind::object DaidalusCEI::sweepDirectionConflicts(lua_State* L, double min_dir, double max_dir, double step)
+{
+	// Upper bound on the number of directions of a sweep, e.g., 0.1 [deg] steps over a full circle
+	const int max_directions = 3601;
+	std::vector<double> dirs;
+	if (!(step > 0)) {
+		printMessage("sweepDirectionConflicts: step must be positive");
+		return directionConflictsTable(L, dirs);
 	}
+	double n = max_dir >= min_dir ? std::floor((max_dir - min_dir) / step + 1e-9) + 1 : 0;
+	if (!(n <= max_directions)) {
+		printMessage("sweepDirectionConflicts: too many directions, increase step");
+		return directionConflictsTable(L, dirs);
+	}
+	// Directions are computed from an integer index so that rounding errors don't accumulate
+	for (int i = 0; i < static_cast<int>(n); i++) {
+		dirs.push_back(min_dir + i * step);
+	}
+	return directionConflictsTable(L, dirs);
 }
 
 
@@ -83,15 +103,15 @@ void DaidalusCEI::reloadConfig(bool& ret) {
 
 void DaidalusCEI::setOwnshipState(std::string ido, double lat, double lon, double alt, double velx, double vely, double velz, double to)
 {
-	larcfm::Position pos = larcfm::Position::makeLatLonAlt(lat,"rad", lon,"rad", alt, "m");
-	larcfm::Velocity vel = larcfm::Velocity::makeVxyz(velx, vely, "m/s",velz,"m/s");
+	larcfm::Position pos = larcfm::Position::makeLatLonAlt(lat, larcfm::units::rad, lon, larcfm::units::rad, alt, larcfm::units::m);
+	larcfm::Velocity vel = larcfm::Velocity::makeVxyz(velx, vely, larcfm::units::mps, velz, larcfm::units::mps);
 	daa.setOwnshipState(ido, pos, vel, to);
 }
 
 
 void DaidalusCEI::addTrafficState(int& aci_idx, std::string idi, double lat, double lon, double alt, double velx, double vely, double velz, double to) {
-	larcfm::Position pos = larcfm::Position::makeLatLonAlt(lat, "rad", lon, "rad", alt, "m");
-	larcfm::Velocity vel = larcfm::Velocity::makeVxyz(velx, vely, "m/s", velz, "m/s");
+	larcfm::Position pos = larcfm::Position::makeLatLonAlt(lat, larcfm::units::rad, lon, larcfm::units::rad, alt, larcfm::units::m);
+	larcfm::Velocity vel = larcfm::Velocity::makeVxyz(velx, vely, larcfm::units::mps, velz, larcfm::units::mps);
 
 	if (to != -1)
 		aci_idx = daa.addTrafficState(idi, pos, vel, to);
@@ -99,11 +119,77 @@ void DaidalusCEI::addTrafficState(int& aci_idx, std::string idi, double lat, dou
 		aci_idx = daa.addTrafficState(idi, pos, vel);
 }
 
+void DaidalusCEI::updateOwnshipState(std::string ido, double lat, double lon, double alt, double velx, double vely, double velz, double to)
+{
+	larcfm::Position pos = larcfm::Position::makeLatLonAlt(lat, larcfm::units::rad, lon, larcfm::units::rad, alt, larcfm::units::m);
+	larcfm::Velocity vel = larcfm::Velocity::makeVxyz(velx, vely, larcfm::units::mps, velz, larcfm::units::mps);
+	daa.updateOwnshipState(ido, pos, vel, to);
+}
+
+// Update traffic aircraft in place, keeping its index, alerter and SUM data. Unknown aircraft are added.
+void DaidalusCEI::updateTrafficState(int& aci_idx, std::string idi, double lat, double lon, double alt, double velx, double vely, double velz, double to) {
+	larcfm::Position pos = larcfm::Position::makeLatLonAlt(lat, larcfm::units::rad, lon, larcfm::units::rad, alt, larcfm::units::m);
+	larcfm::Velocity vel = larcfm::Velocity::makeVxyz(velx, vely, larcfm::units::mps, velz, larcfm::units::mps);
+
+	aci_idx = daa.aircraftIndex(idi);
+	if (aci_idx > 0) {
+		if (to != -1)
+			daa.updateTrafficState(aci_idx, pos, vel, to);
+		else
+			daa.updateTrafficState(aci_idx, pos, vel);
+	}
+	else if (to != -1)
+		aci_idx = daa.addTrafficState(idi, pos, vel, to);
+	else
+		aci_idx = daa.addTrafficState(idi, pos, vel);
+}
+
+void DaidalusCEI::removeStaleTraffic(int& removed, double max_age) {
+	removed = daa.removeStaleTraffic(max_age);
+}
+
 
 void DaidalusCEI::getDetectionTime(double& time_to_violation, int ac_idx) {
 	time_to_violation = daa.timeToCorrectiveVolume(ac_idx);
 }
 
+larcfm::DaidalusFleet& DaidalusCEI::fleet() {
+	static larcfm::DaidalusFleet shared_fleet;
+	static bool configured = false;
+	if (!configured) {
+		shared_fleet.setConfiguration(daa);
+		// Only direction resolutions are queried, see getFleetResolutionDirection
+		shared_fleet.setHorizontalDirectionResolutions(true);
+		configured = true;
+	}
+	return shared_fleet;
+}
+
+void DaidalusCEI::setFleetAircraftState(std::string id, double lat, double lon, double alt, double velx, double vely, double velz, double t, bool ownship) {
+	larcfm::Position pos = larcfm::Position::makeLatLonAlt(lat, larcfm::units::rad, lon, larcfm::units::rad, alt, larcfm::units::m);
+	larcfm::Velocity vel = larcfm::Velocity::makeVxyz(velx, vely, larcfm::units::mps, velz, larcfm::units::mps);
+	fleet().setAircraftState(id, pos, vel, t, ownship);
+}
+
+// Same conventions as getResolutionDirection, for the given ownship of the fleet
+void DaidalusCEI::getFleetResolutionDirection(double& trackOrHeading, std::string id, bool is_right) {
+	const larcfm::DaidalusFleet::Summary& summary = fleet().getSummary(id);
+	double right = larcfm::Units::to(larcfm::units::deg, summary.horizontal_direction_resolution[1]);
+	double left = larcfm::Units::to(larcfm::units::deg, summary.horizontal_direction_resolution[0]);
+	if (is_right) {
+		trackOrHeading = right;
+		// If infinite, check the other direction.
+		if (ISINF(trackOrHeading)) trackOrHeading = ISNINF(left) ? -1 : left;
+	}
+	else {
+		trackOrHeading = left;
+		// If infinite, check the other direction.
+		if (ISNINF(trackOrHeading)) trackOrHeading = ISINF(right) ? -1 : right;
+	}
+	// There is no conflict.
+	if (ISNAN(trackOrHeading)) trackOrHeading = -2;
+}
+
 void DaidalusCEI::printMessage(const std::string& message) {
 	DtWarn << myEntity->objectName().string() << ": " << message.c_str() << std::endl;
 	myEntity->objectConsoleInfo() << message << std::endl;
@@ -160,6 +246,11 @@ void DaidalusCEI::bindLuaFunctions(DtLocalObject* entity, const DtString& script
 		.def("setOwnshipState", &DaidalusCEI::setOwnshipState)
 		.def("addTrafficState", &DaidalusCEI::addTrafficState,
 			luabind::pure_out_value(_2))
+		.def("updateOwnshipState", &DaidalusCEI::updateOwnshipState)
+		.def("updateTrafficState", &DaidalusCEI::updateTrafficState,
+			luabind::pure_out_value(_2))
+		.def("removeStaleTraffic", &DaidalusCEI::removeStaleTraffic,
+			luabind::pure_out_value(_2))
 		.def("getDetectionTime", &DaidalusCEI::getDetectionTime,
 			luabind::pure_out_value(_2))
 		.def("setWindVelocityTo", &DaidalusCEI::setWindVelocityTo)
@@ -181,6 +272,8 @@ void DaidalusCEI::bindLuaFunctions(DtLocalObject* entity, const DtString& script
 		.def("reloadConfig", &DaidalusCEI::reloadConfig,
 			luabind::pure_out_value(_2))
 		.def("getHorizontalDirectionBands", &DaidalusCEI::getHorizontalDirectionBands)
+		.def("setParallelBands", &DaidalusCEI::setParallelBands)
+		.def("refreshBands", &DaidalusCEI::refreshBands)
 		.def("setAlertingTime", &DaidalusCEI::setAlertingTime,
 			luabind::pure_out_value(_2))
 		.def("getAlertingTime", &DaidalusCEI::getAlertingTime,
@@ -189,6 +282,8 @@ void DaidalusCEI::bindLuaFunctions(DtLocalObject* entity, const DtString& script
 			luabind::pure_out_value(_2))
 		.def("isDirectionInConflict", &DaidalusCEI::isDirectionInConflict,
 			luabind::pure_out_value(_2))
+		.def("getDirectionConflicts", &DaidalusCEI::getDirectionConflicts)
+		.def("sweepDirectionConflicts", &DaidalusCEI::sweepDirectionConflicts)
 		.def("getClosureRate", &DaidalusCEI::getClosureRate,
 			luabind::pure_out_value(_2))
 		.def("getHorizontalDistance", &DaidalusCEI::getHorizontalDistance,
@@ -205,6 +300,21 @@ void DaidalusCEI::bindLuaFunctions(DtLocalObject* entity, const DtString& script
 			luabind::pure_out_value(_2))
 		.def("isPreferredRight", &DaidalusCEI::isPreferredRight,
 			luabind::pure_out_value(_2))
+		.def("setFleetConfiguration", &DaidalusCEI::setFleetConfiguration)
+		.def("setFleetAircraftState", &DaidalusCEI::setFleetAircraftState)
+		.def("removeFleetAircraft", &DaidalusCEI::removeFleetAircraft,
+			luabind::pure_out_value(_2))
+		.def("computeFleet", &DaidalusCEI::computeFleet)
+		.def("getFleetAlertLevel", &DaidalusCEI::getFleetAlertLevel,
+			luabind::pure_out_value(_2))
+		.def("getFleetDetectionTime", &DaidalusCEI::getFleetDetectionTime,
+			luabind::pure_out_value(_2))
+		.def("getFleetResolutionDirection", &DaidalusCEI::getFleetResolutionDirection,
+			luabind::pure_out_value(_2))
+		.def("getFleetTime2CPA", &DaidalusCEI::getFleetTime2CPA,
+			luabind::pure_out_value(_2))
+		.def("getFleetHMD", &DaidalusCEI::getFleetHMD,
+			luabind::pure_out_value(_2))
 		//! The multiple return function requires you to specify which arguments are used to return.
 		//! Here, the indexes start at _2 for the first argument in the function. Our sample function
 		//! has the first out value in the argument slot _3. We also have a second out argument at slot
@@ -233,14 +343,14 @@ static std::string num2str(double res, const std::string& u) {
 
 void DaidalusCEI::getResolutionDirection(double& trackOrHeading, bool is_right) {
 	if (is_right) {
-		trackOrHeading = daa.horizontalDirectionResolution(true, "deg");
+		trackOrHeading = daa.horizontalDirectionResolution(true, larcfm::units::deg);
 		// If infinite, check the other direction.
-		if (ISINF(trackOrHeading)) trackOrHeading = ISNINF(daa.horizontalDirectionResolution(false, "deg")) ? -1 : daa.horizontalDirectionResolution(false, "deg");
+		if (ISINF(trackOrHeading)) trackOrHeading = ISNINF(daa.horizontalDirectionResolution(false, larcfm::units::deg)) ? -1 : daa.horizontalDirectionResolution(false, larcfm::units::deg);
 	}
 	else {
-		trackOrHeading = daa.horizontalDirectionResolution(false, "deg");
+		trackOrHeading = daa.horizontalDirectionResolution(false, larcfm::units::deg);
 		// If infinite, check the other direction.
-		if (ISNINF(trackOrHeading)) trackOrHeading = ISINF(daa.horizontalDirectionResolution(true, "deg")) ? -1 : daa.horizontalDirectionResolution(true, "deg");
+		if (ISNINF(trackOrHeading)) trackOrHeading = ISINF(daa.horizontalDirectionResolution(true, larcfm::units::deg)) ? -1 : daa.horizontalDirectionResolution(true, larcfm::units::deg);
 	}
 	// There is no conflict.
 	if (ISNAN(trackOrHeading)) trackOrHeading = -2;